@@ -15,6 +15,12 @@
 #include <esp_sntp.h>
 #include <esp_wifi.h>
 #include <esp_now.h>
+#include <esp_timer.h>
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+  #include <esp_memory_utils.h>
+#else
+  #include <soc/soc_memory_layout.h>
+#endif
 #include <BLEDevice.h>
 #include <BLEUtils.h>
 #include <BLEServer.h>
@@ -70,6 +76,555 @@ struct ConversationContext {
   String lastConversation;
 };
 
+// ============ FRAME CANVAS ============
+// GFXcanvas16 whose pixel buffer can move between internal RAM and PSRAM.
+// Drawing is fastest from internal RAM, but TLS handshakes and big
+// JsonDocuments need that heap more than the UI does while they run.
+class FrameCanvas : public GFXcanvas16 {
+ public:
+  FrameCanvas(uint16_t w, uint16_t h) : GFXcanvas16(w, h) {}
+
+  // Copy the pixels to the other memory. On allocation failure the buffer
+  // stays where it is and false is returned.
+  bool relocate(bool toPsram) {
+    if (buffer == nullptr || toPsram == inPsram) return true;
+    size_t bytes = (size_t)WIDTH * HEIGHT * sizeof(uint16_t);
+    uint16_t* mem = toPsram ? (uint16_t*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+                            : (uint16_t*)heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (mem == nullptr) return false;
+    memcpy(mem, buffer, bytes);
+    heap_caps_free(buffer);
+    buffer = mem;
+    inPsram = toPsram;
+    return true;
+  }
+
+  bool isInPsram() const { return inPsram; }
+
+ private:
+  bool inPsram = esp_ptr_external_ram(buffer); // malloc may have put it there
+};
+
+// ============ FIXED-POINT MATH ============
+// Integer replacements for the libm calls in draw code. Angles are binary
+// (65536 = one turn) so they wrap for free in a uint16_t; sine/cosine come
+// back in Q15. The table is generated at compile time and lands in flash.
+#define FX_SINE_BITS 8
+#define FX_SINE_SIZE (1 << FX_SINE_BITS)
+#define FX_ONE_Q15 32767
+#define FX_ONE_Q16 65536
+
+// Taylor series for |x| <= pi; only ever evaluated by the compiler
+constexpr double fxSinSeries(double x2, double term, int k) {
+  return k > 12 ? term : term + fxSinSeries(x2, -term * x2 / ((2.0 * k) * (2.0 * k + 1.0)), k + 1);
+}
+constexpr double fxSinWrapped(double x) {
+  return fxSinSeries(x * x, x, 1);
+}
+constexpr int16_t fxSinEntry(int i) {
+  return (int16_t)(fxSinWrapped((i < FX_SINE_SIZE / 2 ? i : i - FX_SINE_SIZE) * (2.0 * 3.14159265358979323846 / FX_SINE_SIZE)) * FX_ONE_Q15
+                   + (i < FX_SINE_SIZE / 2 ? 0.5 : -0.5));
+}
+
+template <int... Is> struct FxSeq {};
+template <int N, int... Is> struct FxMakeSeq : FxMakeSeq<N - 1, N - 1, Is...> {};
+template <int... Is> struct FxMakeSeq<0, Is...> { typedef FxSeq<Is...> type; };
+
+template <typename Seq> struct FxSineTable;
+template <int... Is> struct FxSineTable<FxSeq<Is...>> {
+  static constexpr int16_t values[sizeof...(Is)] = { fxSinEntry(Is)... };
+};
+template <int... Is> constexpr int16_t FxSineTable<FxSeq<Is...>>::values[sizeof...(Is)];
+
+typedef FxSineTable<FxMakeSeq<FX_SINE_SIZE>::type> FxSine;
+static_assert(FxSine::values[FX_SINE_SIZE / 4] == FX_ONE_Q15, "sine table peak");
+
+// sin(angle) in Q15, linearly interpolated between table entries
+inline int32_t fxSin(uint16_t angle) {
+  uint32_t i = angle >> (16 - FX_SINE_BITS);
+  int32_t frac = angle & ((1 << (16 - FX_SINE_BITS)) - 1);
+  int32_t a = FxSine::values[i];
+  int32_t b = FxSine::values[(i + 1) & (FX_SINE_SIZE - 1)];
+  return a + (((b - a) * frac) >> (16 - FX_SINE_BITS));
+}
+
+inline int32_t fxCos(uint16_t angle) {
+  return fxSin(angle + 16384);
+}
+
+// Angle of a wave with the given period at time ms
+inline uint16_t fxPhase(uint32_t ms, uint32_t periodMs) {
+  return (uint16_t)(((ms % periodMs) << 16) / periodMs);
+}
+
+// (sin + 1) / 2 in Q16, for pulses that swing between two values
+inline uint32_t fxWave(uint16_t angle) {
+  return (uint32_t)(fxSin(angle) + FX_ONE_Q15 + 1);
+}
+
+// v * q for a Q15 factor, rounded to nearest
+inline int32_t fxMulQ15(int32_t v, int32_t q) {
+  return (v * q + (1 << 14)) >> 15;
+}
+
+// a + (b - a) * t for t in Q16 [0, 65536]
+inline int32_t fxLerp(int32_t a, int32_t b, uint32_t tQ16) {
+  return a + (int32_t)(((int64_t)(b - a) * tQ16) >> 16);
+}
+
+// floor(sqrt(v)), exact for the whole range
+inline uint32_t fxSqrt(uint32_t v) {
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > v) bit >>= 2;
+  while (bit) {
+    if (v >= root + bit) {
+      v -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+// 1/sqrt(x) from the exponent trick plus two Newton steps (~5e-6 relative)
+inline float fxInvSqrt(float x) {
+  uint32_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  bits = 0x5f375a86 - (bits >> 1);
+  float y;
+  memcpy(&y, &bits, sizeof(y));
+  float half = 0.5f * x;
+  y = y * (1.5f - half * y * y);
+  y = y * (1.5f - half * y * y);
+  return y;
+}
+
+#ifdef FIXED_MATH_BENCH
+// Build with -DFIXED_MATH_BENCH to print error bounds and timings against
+// libm once from setup().
+void runFixedMathBenchmark() {
+  const int32_t iterations = 65536;
+  volatile int32_t sinkI = 0;
+  volatile float sinkF = 0;
+
+  float maxSinErr = 0;
+  for (int32_t a = 0; a < 65536; a++) {
+    float ref = sinf(a * (2.0f * PI / 65536.0f));
+    float err = fabsf(fxSin((uint16_t)a) / 32767.0f - ref);
+    if (err > maxSinErr) maxSinErr = err;
+  }
+  Serial.printf("[FXMATH] fxSin max error %.6f (%.2f px at r=100)\n", maxSinErr, maxSinErr * 100);
+
+  bool sqrtExact = true;
+  for (uint32_t v = 0; v < 200000 && sqrtExact; v++) {
+    uint32_t r = fxSqrt(v);
+    if (r * r > v || (r + 1) * (r + 1) <= v) sqrtExact = false;
+  }
+  Serial.printf("[FXMATH] fxSqrt 0..200000: %s\n", sqrtExact ? "exact" : "MISMATCH");
+
+  float maxInvErr = 0;
+  for (float x = 0.001f; x < 100000.0f; x *= 1.01f) {
+    float ref = 1.0f / sqrtf(x);
+    float err = fabsf(fxInvSqrt(x) - ref) / ref;
+    if (err > maxInvErr) maxInvErr = err;
+  }
+  Serial.printf("[FXMATH] fxInvSqrt max relative error %.7f\n", maxInvErr);
+
+  auto report = [&](const char* name, unsigned long us) {
+    Serial.printf("[FXMATH] %-12s %6.1f ns/call\n", name, us * 1000.0f / iterations);
+  };
+  unsigned long t;
+
+  t = micros();
+  for (int32_t a = 0; a < iterations; a++) sinkF = sinkF + sinf(a * 0.05f);
+  report("sinf", micros() - t);
+
+  t = micros();
+  for (int32_t a = 0; a < iterations; a++) sinkI = sinkI + fxSin((uint16_t)(a * 522));
+  report("fxSin", micros() - t);
+
+  t = micros();
+  for (int32_t a = 0; a < iterations; a++) sinkF = sinkF + sqrtf((float)a);
+  report("sqrtf", micros() - t);
+
+  t = micros();
+  for (int32_t a = 0; a < iterations; a++) sinkI = sinkI + fxSqrt((uint32_t)a);
+  report("fxSqrt", micros() - t);
+
+  t = micros();
+  for (int32_t a = 1; a <= iterations; a++) sinkF = sinkF + 1.0f / sqrtf((float)a);
+  report("1/sqrtf", micros() - t);
+
+  t = micros();
+  for (int32_t a = 1; a <= iterations; a++) sinkF = sinkF + fxInvSqrt((float)a);
+  report("fxInvSqrt", micros() - t);
+}
+#endif
+
+// ============ PRNG ============
+// xoshiro128** streams for effects and games. Arduino's random() goes through
+// the hardware RNG and a modulo on every call; these are a few shifts and one
+// multiply. Each subsystem draws from its own stream so that reseeding one
+// (a benchmark, a shared race track) doesn't disturb the others.
+struct Rng {
+  uint32_t s[4];
+};
+
+Rng rngEffects;   // Visualizers, starfields, screensaver particles
+Rng rngParticles; // Game particles and screen shake
+Rng rngGame;      // Game rules: spawns, food, AI choices, shuffles
+Rng rngTrack;     // Racing track layout
+
+// splitmix32 expands one word into a full state, never all zero
+void rngSeed(Rng& r, uint32_t seed) {
+  for (int i = 0; i < 4; i++) {
+    uint32_t z = (seed += 0x9E3779B9u);
+    z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+    z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+    r.s[i] = z ^ (z >> 16);
+  }
+}
+
+void rngSeedAll(uint32_t seed) {
+  rngSeed(rngEffects, seed);
+  rngSeed(rngParticles, seed ^ 0x2545F491u);
+  rngSeed(rngGame, seed ^ 0x6C8E9CF5u);
+  rngSeed(rngTrack, seed ^ 0xB5297A4Du);
+}
+
+inline uint32_t rngNext(Rng& r) {
+  uint32_t* s = r.s;
+  uint32_t x = s[1] * 5;
+  uint32_t result = ((x << 7) | (x >> 25)) * 9;
+  uint32_t t = s[1] << 9;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = (s[3] << 11) | (s[3] >> 21);
+  return result;
+}
+
+// [0, n) by multiply-shift instead of modulo (bias below n / 2^32)
+inline uint32_t rngBelow(Rng& r, uint32_t n) {
+  return (uint32_t)(((uint64_t)rngNext(r) * n) >> 32);
+}
+
+// [lo, hi), same contract as random(lo, hi)
+inline int32_t rngRange(Rng& r, int32_t lo, int32_t hi) {
+  return hi <= lo ? lo : lo + (int32_t)rngBelow(r, (uint32_t)(hi - lo));
+}
+
+// [0, 1)
+inline float rngFloat(Rng& r) {
+  return (rngNext(r) >> 8) * (1.0f / 16777216.0f);
+}
+
+// ============ RGB565 PIXEL KERNELS ============
+// Span routines on the raw canvas buffer. Callers clip once per rect, so the
+// inner loops carry no bounds checks. PIXEL_KERNELS_SWAR picks the packed path
+// (red and blue blended with one 32-bit multiply); the scalar path is the
+// reference and both produce identical pixels.
+#ifndef PIXEL_KERNELS_SWAR
+#define PIXEL_KERNELS_SWAR 1
+#endif
+
+bool clipToScreen(int16_t& x, int16_t& y, int16_t& w, int16_t& h) {
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > SCREEN_WIDTH) w = SCREEN_WIDTH - x;
+  if (y + h > SCREEN_HEIGHT) h = SCREEN_HEIGHT - y;
+  return w > 0 && h > 0;
+}
+
+void spanFill565Scalar(uint16_t* dst, int n, uint16_t color) {
+  for (int i = 0; i < n; i++) dst[i] = color;
+}
+
+void spanFill565Swar(uint16_t* dst, int n, uint16_t color) {
+  if (n <= 0) return;
+  if ((uintptr_t)dst & 2) {
+    *dst++ = color;
+    n--;
+  }
+  uint32_t pair = color | ((uint32_t)color << 16);
+  uint32_t* dst32 = (uint32_t*)dst;
+  int pairs = n >> 1;
+  int i = 0;
+  for (; i + 4 <= pairs; i += 4) {
+    dst32[i] = pair; dst32[i + 1] = pair; dst32[i + 2] = pair; dst32[i + 3] = pair;
+  }
+  for (; i < pairs; i++) dst32[i] = pair;
+  if (n & 1) dst[n - 1] = color;
+}
+
+// Per channel: (dst * (255 - alpha) + color * alpha) >> 8
+void spanBlend565Scalar(uint16_t* dst, int n, uint16_t color, uint8_t alpha) {
+  uint16_t inv = 255 - alpha;
+  uint16_t rS = ((color >> 11) & 0x1F) * alpha;
+  uint16_t gS = ((color >> 5) & 0x3F) * alpha;
+  uint16_t bS = (color & 0x1F) * alpha;
+  for (int i = 0; i < n; i++) {
+    uint16_t d = dst[i];
+    uint16_t r = (((d >> 11) & 0x1F) * inv + rS) >> 8;
+    uint16_t g = (((d >> 5) & 0x3F) * inv + gS) >> 8;
+    uint16_t b = ((d & 0x1F) * inv + bS) >> 8;
+    dst[i] = (r << 11) | (g << 5) | b;
+  }
+}
+
+// Red moved to bits 16-20 so red and blue share one multiply without carries
+// (31 * 255 < 2^13); green is blended in place.
+void spanBlend565Swar(uint16_t* dst, int n, uint16_t color, uint8_t alpha) {
+  uint32_t inv = 255 - alpha;
+  uint32_t rbS = ((((uint32_t)color & 0xF800) << 5) | (color & 0x001F)) * alpha;
+  uint32_t gS = ((uint32_t)color & 0x07E0) * alpha;
+  for (int i = 0; i < n; i++) {
+    uint32_t d = dst[i];
+    uint32_t rb = ((((d & 0xF800) << 5) | (d & 0x001F)) * inv + rbS) >> 8;
+    uint32_t g = ((d & 0x07E0) * inv + gS) >> 8;
+    dst[i] = ((rb >> 5) & 0xF800) | (g & 0x07E0) | (rb & 0x001F);
+  }
+}
+
+// Cross-fade of two spans: (a * (255 - alpha) + b * alpha) >> 8, same
+// packing as spanBlend565Swar
+void spanMix565(uint16_t* dst, const uint16_t* a, const uint16_t* b, int n, uint8_t alpha) {
+  uint32_t inv = 255 - alpha;
+  for (int i = 0; i < n; i++) {
+    uint32_t p = a[i], q = b[i];
+    uint32_t rb = ((((p & 0xF800) << 5) | (p & 0x001F)) * inv + (((q & 0xF800) << 5) | (q & 0x001F)) * alpha) >> 8;
+    uint32_t g = ((p & 0x07E0) * inv + (q & 0x07E0) * alpha) >> 8;
+    dst[i] = ((rb >> 5) & 0xF800) | (g & 0x07E0) | (rb & 0x001F);
+  }
+}
+
+void spanCopy565(uint16_t* dst, const uint16_t* src, int n) {
+  memcpy(dst, src, n * sizeof(uint16_t));
+}
+
+// Writes `count` pixels of a c1 -> c2 gradient that is `steps` long, starting at
+// position `pos`, advancing `stride` pixels per step.
+void spanGradient565(uint16_t* dst, int count, int stride, uint16_t c1, uint16_t c2, int pos, int steps) {
+  int r1 = (c1 >> 11) & 0x1F, g1 = (c1 >> 5) & 0x3F, b1 = c1 & 0x1F;
+  int r2 = (c2 >> 11) & 0x1F, g2 = (c2 >> 5) & 0x3F, b2 = c2 & 0x1F;
+  for (int i = 0; i < count; i++, pos++, dst += stride) {
+    int r = (r1 * (steps - pos) + r2 * pos) / steps;
+    int g = (g1 * (steps - pos) + g2 * pos) / steps;
+    int b = (b1 * (steps - pos) + b2 * pos) / steps;
+    *dst = (r << 11) | (g << 5) | b;
+  }
+}
+
+inline void spanFill565(uint16_t* dst, int n, uint16_t color) {
+#if PIXEL_KERNELS_SWAR
+  spanFill565Swar(dst, n, color);
+#else
+  spanFill565Scalar(dst, n, color);
+#endif
+}
+
+inline void spanBlend565(uint16_t* dst, int n, uint16_t color, uint8_t alpha) {
+#if PIXEL_KERNELS_SWAR
+  spanBlend565Swar(dst, n, color, alpha);
+#else
+  spanBlend565Scalar(dst, n, color, alpha);
+#endif
+}
+
+#ifdef PIXEL_KERNEL_BENCH
+// Build with -DPIXEL_KERNEL_BENCH to run once from setup(). Uses the canvas
+// buffer as scratch, so it must run before anything is drawn.
+void runPixelKernelBenchmark() {
+  extern FrameCanvas canvas;
+  uint16_t* buf = canvas.getBuffer();
+  const int total = SCREEN_WIDTH * SCREEN_HEIGHT;
+  const int passes = 50;
+  uint16_t ref[SCREEN_WIDTH], out[SCREEN_WIDTH];
+
+  // Bit-exactness of the SWAR paths against the scalar reference
+  bool exact = true;
+  for (int alpha = 0; alpha < 256 && exact; alpha++) {
+    uint16_t color = (uint16_t)esp_random();
+    for (int i = 0; i < SCREEN_WIDTH; i++) ref[i] = out[i] = (uint16_t)esp_random();
+    spanBlend565Scalar(ref, SCREEN_WIDTH, color, alpha);
+    spanBlend565Swar(out, SCREEN_WIDTH, color, alpha);
+    if (memcmp(ref, out, sizeof(ref)) != 0) exact = false;
+    spanFill565Scalar(ref + 1, SCREEN_WIDTH - 2, color);
+    spanFill565Swar(out + 1, SCREEN_WIDTH - 2, color);
+    if (memcmp(ref, out, sizeof(ref)) != 0) exact = false;
+  }
+  Serial.printf("[KERNEL] SWAR vs scalar: %s\n", exact ? "bit-exact" : "MISMATCH");
+
+  auto report = [&](const char* name, unsigned long us) {
+    float mps = us > 0 ? (float)total * passes / us : 0.0f;
+    Serial.printf("[KERNEL] %-16s %7.1f MP/s\n", name, mps);
+  };
+  unsigned long t;
+
+  t = micros();
+  for (int p = 0; p < passes; p++)
+    for (int y = 0; y < SCREEN_HEIGHT; y++) spanFill565Scalar(buf + y * SCREEN_WIDTH, SCREEN_WIDTH, 0x1234 + p);
+  report("fill scalar", micros() - t);
+
+  t = micros();
+  for (int p = 0; p < passes; p++)
+    for (int y = 0; y < SCREEN_HEIGHT; y++) spanFill565Swar(buf + y * SCREEN_WIDTH, SCREEN_WIDTH, 0x1234 + p);
+  report("fill swar", micros() - t);
+
+  t = micros();
+  for (int p = 0; p < passes; p++)
+    for (int y = 0; y < SCREEN_HEIGHT; y++) spanBlend565Scalar(buf + y * SCREEN_WIDTH, SCREEN_WIDTH, COLOR_TEAL_SOFT, 180);
+  report("blend scalar", micros() - t);
+
+  t = micros();
+  for (int p = 0; p < passes; p++)
+    for (int y = 0; y < SCREEN_HEIGHT; y++) spanBlend565Swar(buf + y * SCREEN_WIDTH, SCREEN_WIDTH, COLOR_TEAL_SOFT, 180);
+  report("blend swar", micros() - t);
+
+  t = micros();
+  for (int p = 0; p < passes; p++)
+    for (int y = 1; y < SCREEN_HEIGHT; y++) spanCopy565(buf + y * SCREEN_WIDTH, buf + (y - 1) * SCREEN_WIDTH, SCREEN_WIDTH);
+  report("copy", micros() - t);
+
+  t = micros();
+  for (int p = 0; p < passes; p++)
+    for (int y = 0; y < SCREEN_HEIGHT; y++) spanGradient565(buf + y * SCREEN_WIDTH, SCREEN_WIDTH, 1, COLOR_SLATE_BG_DARK, COLOR_TEAL_SOFT, 0, SCREEN_WIDTH);
+  report("gradient", micros() - t);
+
+  memset(buf, 0, total * sizeof(uint16_t));
+}
+#endif
+
+// ============ QUALITY GOVERNOR ============
+// Continuous screens report each frame's interval and render cost. When the
+// smoothed interval stays over the frame budget the quality level steps down;
+// when rendering leaves plenty of headroom for long enough it steps back up.
+// The gap between the two thresholds and the longer wait before raising keep
+// it from oscillating. Effects read their knobs from the current level.
+#define QUALITY_MAX 3
+#define QUALITY_FRAME_BUDGET_US 33333UL // Hold at least 30 fps
+#define QUALITY_DOWN_PERCENT 115        // Smoothed interval above this % of budget...
+#define QUALITY_DOWN_FRAMES 15          // ...for this many frames lowers quality
+#define QUALITY_UP_PERCENT 60           // Render cost below this % of budget...
+#define QUALITY_UP_FRAMES 90            // ...for this many frames raises it
+
+uint8_t renderQuality = QUALITY_MAX;
+
+struct QualityGovernor {
+  uint32_t budgetUs;
+  uint32_t intervalEma; // Smoothed over 8 frames
+  uint32_t costEma;
+  uint16_t pressure;    // Consecutive frames over budget
+  uint16_t headroom;    // Consecutive frames with spare time
+};
+
+QualityGovernor qualityGov = {QUALITY_FRAME_BUDGET_US, 0, 0, 0, 0};
+
+// Back to full quality, e.g. when the screen changes
+void qualityGovernorReset(uint32_t budgetUs) {
+  renderQuality = QUALITY_MAX;
+  qualityGov = {budgetUs > QUALITY_FRAME_BUDGET_US ? budgetUs : (uint32_t)QUALITY_FRAME_BUDGET_US, 0, 0, 0, 0};
+}
+
+void qualityGovernorFrame(uint32_t intervalUs, uint32_t costUs) {
+  QualityGovernor& g = qualityGov;
+  if (g.intervalEma == 0) {
+    g.intervalEma = intervalUs;
+    g.costEma = costUs;
+  } else {
+    g.intervalEma += ((int32_t)intervalUs - (int32_t)g.intervalEma) / 8;
+    g.costEma += ((int32_t)costUs - (int32_t)g.costEma) / 8;
+  }
+
+  if (g.intervalEma * 100 > g.budgetUs * QUALITY_DOWN_PERCENT) {
+    g.pressure++;
+    g.headroom = 0;
+  } else if (g.costEma * 100 < g.budgetUs * QUALITY_UP_PERCENT) {
+    g.headroom++;
+    g.pressure = 0;
+  } else {
+    g.pressure = 0;
+    g.headroom = 0;
+  }
+
+  int8_t step = 0;
+  if (g.pressure >= QUALITY_DOWN_FRAMES && renderQuality > 0) step = -1;
+  else if (g.headroom >= QUALITY_UP_FRAMES && renderQuality < QUALITY_MAX) step = 1;
+  if (step == 0) return;
+
+  renderQuality += step;
+  g.pressure = 0;
+  g.headroom = 0;
+  Serial.printf("[quality] level %u (frame %.1f ms, render %.1f ms, budget %.1f ms)\n", renderQuality,
+                g.intervalEma / 1000.0f, g.costEma / 1000.0f, g.budgetUs / 1000.0f);
+}
+
+// Share of a particle/star pool to simulate: 100%, 75%, 50%, 25%
+int qualityScaleCount(int full) {
+  return max(1, full * (renderQuality + 1) / (QUALITY_MAX + 1));
+}
+
+// Racing draw distance for scenery and cars
+float qualityDrawDistance() {
+  static const float distance[QUALITY_MAX + 1] = {2000.0f, 2700.0f, 3400.0f, 4000.0f};
+  return distance[renderQuality];
+}
+
+int qualityGlowPasses() {
+  return renderQuality >= 2 ? 3 : renderQuality + 1;
+}
+
+// Road scanlines computed per drawn line: the lowest levels fill every other
+// row by copying the one below it
+int qualityRoadRowStep() {
+  return renderQuality >= 2 ? 1 : 2;
+}
+
+// ============ GRADIENT CACHE ============
+// Gradient ramps (one color per step) keyed by their endpoints and length.
+// Callers that redraw the same gradient every frame fill rows from the ramp
+// or memcpy it instead of re-interpolating.
+#define GRADIENT_CACHE_SLOTS 4
+
+struct GradientRamp {
+  uint16_t c1, c2;
+  int16_t steps;
+  uint16_t* colors;
+  uint32_t lastUse;
+};
+
+GradientRamp gradientCache[GRADIENT_CACHE_SLOTS];
+uint32_t gradientCacheTick = 0;
+
+const uint16_t* getGradientRamp(uint16_t c1, uint16_t c2, int16_t steps) {
+  gradientCacheTick++;
+  GradientRamp* slot = &gradientCache[0];
+  for (int i = 0; i < GRADIENT_CACHE_SLOTS; i++) {
+    GradientRamp& g = gradientCache[i];
+    if (g.colors != nullptr && g.c1 == c1 && g.c2 == c2 && g.steps == steps) {
+      g.lastUse = gradientCacheTick;
+      return g.colors;
+    }
+    if (g.lastUse < slot->lastUse) slot = &g;
+  }
+
+  // Miss: rebuild the least recently used slot
+  uint16_t* colors = (uint16_t*)realloc(slot->colors, steps * sizeof(uint16_t));
+  if (colors == nullptr) return nullptr;
+  spanGradient565(colors, steps, 1, c1, c2, 0, steps);
+  slot->colors = colors;
+  slot->c1 = c1;
+  slot->c2 = c2;
+  slot->steps = steps;
+  slot->lastUse = gradientCacheTick;
+  return colors;
+}
+
 uint16_t mixColors(uint16_t color1, uint16_t color2, uint8_t ratio) {
   uint8_t r1 = (color1 >> 11) & 0x1F;
   uint8_t g1 = (color1 >> 5) & 0x3F;
@@ -87,86 +642,315 @@ uint16_t mixColors(uint16_t color1, uint16_t color2, uint8_t ratio) {
 }
 
 void fillRectAlpha(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color, uint8_t alpha) {
-  extern GFXcanvas16 canvas;
+  extern FrameCanvas canvas;
   if (alpha == 0) return;
   if (alpha == 255) {
     canvas.fillRect(x, y, w, h, color);
     return;
   }
+  if (!clipToScreen(x, y, w, h)) return;
 
-  uint16_t* buf = canvas.getBuffer();
-  uint16_t r2 = (color >> 11) & 0x1F;
-  uint16_t g2 = (color >> 5) & 0x3F;
-  uint16_t b2 = color & 0x1F;
-
-  for (int16_t j = y; j < y + h; j++) {
-    if (j < 0 || j >= SCREEN_HEIGHT) continue;
-    for (int16_t i = x; i < x + w; i++) {
-      if (i < 0 || i >= SCREEN_WIDTH) continue;
-      int32_t idx = (int32_t)j * SCREEN_WIDTH + i;
-      if (idx < 0 || idx >= (SCREEN_WIDTH * SCREEN_HEIGHT)) continue;
-      uint16_t color1 = buf[idx];
-      uint16_t r1 = (color1 >> 11) & 0x1F;
-      uint16_t g1 = (color1 >> 5) & 0x3F;
-      uint16_t b1 = color1 & 0x1F;
-
-      uint16_t r = (r1 * (255 - alpha) + r2 * alpha) >> 8;
-      uint16_t g = (g1 * (255 - alpha) + g2 * alpha) >> 8;
-      uint16_t b = (b1 * (255 - alpha) + b2 * alpha) >> 8;
-
-      buf[idx] = (r << 11) | (g << 5) | b;
-    }
+  uint16_t* row = canvas.getBuffer() + (int32_t)y * SCREEN_WIDTH + x;
+  for (int16_t j = 0; j < h; j++, row += SCREEN_WIDTH) {
+    spanBlend565(row, w, color, alpha);
   }
 }
 
 void drawGradientRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color1, uint16_t color2, bool vertical) {
-  extern GFXcanvas16 canvas;
-  uint8_t r1 = (color1 >> 11) & 0x1F;
-  uint8_t g1 = (color1 >> 5) & 0x3F;
-  uint8_t b1 = color1 & 0x1F;
-
-  uint8_t r2 = (color2 >> 11) & 0x1F;
-  uint8_t g2 = (color2 >> 5) & 0x3F;
-  uint8_t b2 = color2 & 0x1F;
+  extern FrameCanvas canvas;
+  int16_t x0 = x, y0 = y, fullW = w, fullH = h;
+  if (!clipToScreen(x, y, w, h)) return;
 
+  uint16_t* buf = canvas.getBuffer();
+  uint16_t* row = buf + (int32_t)y * SCREEN_WIDTH + x;
+  const uint16_t* ramp = getGradientRamp(color1, color2, vertical ? fullH : fullW);
   if (vertical) {
-    for (int16_t i = 0; i < h; i++) {
-      uint8_t r = (r1 * (h - i) + r2 * i) / h;
-      uint8_t g = (g1 * (h - i) + g2 * i) / h;
-      uint8_t b = (b1 * (h - i) + b2 * i) / h;
-      canvas.drawFastHLine(x, y + i, w, (r << 11) | (g << 5) | b);
+    for (int16_t j = 0; j < h; j++, row += SCREEN_WIDTH) {
+      uint16_t color;
+      if (ramp) color = ramp[y - y0 + j];
+      else spanGradient565(&color, 1, 1, color1, color2, y - y0 + j, fullH);
+      spanFill565(row, w, color);
     }
   } else {
-    for (int16_t i = 0; i < w; i++) {
-      uint8_t r = (r1 * (w - i) + r2 * i) / w;
-      uint8_t g = (g1 * (w - i) + g2 * i) / w;
-      uint8_t b = (b1 * (w - i) + b2 * i) / w;
-      canvas.drawFastVLine(x + i, y, h, (r << 11) | (g << 5) | b);
+    // Every row is the same slice of the ramp
+    if (ramp) spanCopy565(row, ramp + (x - x0), w);
+    else spanGradient565(row, w, 1, color1, color2, x - x0, fullW);
+    for (int16_t j = 1; j < h; j++) {
+      spanCopy565(row + (int32_t)j * SCREEN_WIDTH, row, w);
     }
   }
 }
 
+// Row spans of the sun for the last radius drawn (width 0 = striped gap)
+int16_t synthSunRadius = -1;
+int16_t* synthSunWidths = nullptr;
+uint16_t* synthSunColors = nullptr;
+
 void drawSynthSun(int16_t x, int16_t y, int16_t radius) {
-  extern GFXcanvas16 canvas;
+  extern FrameCanvas canvas;
+  if (radius <= 0) return;
+  if (radius != synthSunRadius) {
+    int16_t* widths = (int16_t*)realloc(synthSunWidths, radius * 2 * sizeof(int16_t));
+    if (widths) synthSunWidths = widths;
+    uint16_t* colors = (uint16_t*)realloc(synthSunColors, radius * 2 * sizeof(uint16_t));
+    if (colors) synthSunColors = colors;
+    if (!widths || !colors) {
+      synthSunRadius = -1;
+      return;
+    }
+    for (int16_t i = 0; i < radius * 2; i++) {
+      int32_t h = abs(i - radius);
+      synthSunWidths[i] = (i > radius && (i % 10 < 3)) ? 0 : (int16_t)fxSqrt(4 * (radius * radius - h * h));
+      synthSunColors[i] = mixColors(COLOR_TEAL_ACCENT, COLOR_TEAL_SOFT, (i * 255) / (radius * 2));
+    }
+    synthSunRadius = radius;
+  }
+
   for (int16_t i = 0; i < radius * 2; i++) {
-    int16_t lineY = y - radius + i;
-    float h = abs(i - radius);
-    int16_t w = sqrt(radius * radius - h * h) * 2;
-    if (i > radius && (i % 10 < 3)) continue;
-    uint16_t color = mixColors(COLOR_TEAL_ACCENT, COLOR_TEAL_SOFT, (i * 255) / (radius * 2));
-    canvas.drawFastHLine(x - w / 2, lineY, w, color);
+    int16_t w = synthSunWidths[i];
+    if (w == 0) continue;
+    canvas.drawFastHLine(x - w / 2, y - radius + i, w, synthSunColors[i]);
   }
 }
 
 void drawSelectionGlow(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
-  float pulse = (sin(millis() / 200.0f) + 1.0f) / 2.0f;
-  uint8_t alpha = 40 + (pulse * 40);
-  for (int i = 1; i <= 3; i++) {
+  uint8_t alpha = fxLerp(40, 80, fxWave(fxPhase(millis(), 1257)));
+  int passes = qualityGlowPasses();
+  for (int i = 1; i <= passes; i++) {
     fillRectAlpha(x - i, y - i, w + (i * 2), h + (i * 2), color, alpha / (i * 2));
   }
 }
 
 
+// ============ PARTICLE ENGINE ============
+// Structure-of-arrays particle pools shared by the effects and games. Live
+// particles stay packed at [0, live): a dead one is replaced by the last live
+// particle, so the slots past `live` are the free list and spawning is O(1).
+// Positions and velocities are Q8 pixels (per frame) and integrate in plain
+// integer passes. Drawing buckets particles by size class and fills spans
+// straight into the canvas.
+#define PARTICLE_MAX_SIZE 4 // Largest square side / disc radius
+
+enum ParticleShape : uint8_t {
+  PARTICLE_SQUARE, // size = side, anchored top-left like fillRect
+  PARTICLE_DISC    // size = radius, centered like fillCircle
+};
+
+struct ParticlePool {
+  uint16_t capacity;
+  uint16_t limit;     // Spawn cap, at most capacity
+  uint16_t live;
+  ParticleShape shape;
+  uint8_t shrinkAt;   // Drawn at size 1 once life <= shrinkAt (0 = never)
+  bool cullOffTop;    // Dies when it rises above the screen
+  bool fade;          // Color runs from the spawn color to fadeTo over its life
+  uint16_t fadeTo;
+  // SoA storage, one heap block allocated on first spawn
+  int32_t* x;
+  int32_t* y;
+  int16_t* vx;
+  int16_t* vy;
+  uint16_t* life;
+  uint16_t* maxLife;
+  uint16_t* color;
+  uint16_t* order;    // Draw scratch: indices grouped by size class
+  uint8_t* size;
+};
+
+ParticlePool makeParticlePool(uint16_t capacity, ParticleShape shape, uint8_t shrinkAt = 0,
+                              bool cullOffTop = false, bool fade = false, uint16_t fadeTo = 0) {
+  ParticlePool p;
+  memset(&p, 0, sizeof(p));
+  p.capacity = capacity;
+  p.limit = capacity;
+  p.shape = shape;
+  p.shrinkAt = shrinkAt;
+  p.cullOffTop = cullOffTop;
+  p.fade = fade;
+  p.fadeTo = fadeTo;
+  return p;
+}
+
+bool particlePoolReserve(ParticlePool& p) {
+  if (p.x) return true;
+  size_t n = p.capacity;
+  uint8_t* block = (uint8_t*)malloc(n * (2 * sizeof(int32_t) + 6 * sizeof(uint16_t) + sizeof(uint8_t)));
+  if (block == nullptr) return false;
+  p.x = (int32_t*)block;
+  p.y = p.x + n;
+  p.vx = (int16_t*)(p.y + n);
+  p.vy = p.vx + n;
+  p.life = (uint16_t*)(p.vy + n);
+  p.maxLife = p.life + n;
+  p.color = p.maxLife + n;
+  p.order = p.color + n;
+  p.size = (uint8_t*)(p.order + n);
+  return true;
+}
+
+void particlePoolFree(ParticlePool& p) {
+  free(p.x);
+  p.x = nullptr;
+  p.live = 0;
+}
+
+void particlesClear(ParticlePool& p) {
+  p.live = 0;
+}
+
+// Lowers (or restores) the spawn cap; particles beyond it are dropped now
+void particlesSetLimit(ParticlePool& p, uint16_t limit) {
+  p.limit = limit < p.capacity ? limit : p.capacity;
+  if (p.live > p.limit) p.live = p.limit;
+}
+
+bool particleSpawn(ParticlePool& p, float x, float y, float vx, float vy, uint16_t life, uint16_t color, uint8_t size) {
+  if (life == 0 || p.live >= p.limit || !particlePoolReserve(p)) return false;
+  uint16_t i = p.live++;
+  p.x[i] = (int32_t)(x * 256.0f);
+  p.y[i] = (int32_t)(y * 256.0f);
+  p.vx[i] = (int16_t)(vx * 256.0f);
+  p.vy[i] = (int16_t)(vy * 256.0f);
+  p.life[i] = life;
+  p.maxLife[i] = life;
+  p.color[i] = color;
+  p.size[i] = size < 1 ? 1 : (size > PARTICLE_MAX_SIZE ? PARTICLE_MAX_SIZE : size);
+  return true;
+}
+
+void particlesUpdate(ParticlePool& p) {
+  uint16_t n = p.live;
+  int32_t* x = p.x;
+  int32_t* y = p.y;
+  uint16_t* life = p.life;
+  for (uint16_t i = 0; i < n; i++) x[i] += p.vx[i];
+  for (uint16_t i = 0; i < n; i++) y[i] += p.vy[i];
+  for (uint16_t i = 0; i < n; i++) life[i]--;
+
+  for (uint16_t i = 0; i < n;) {
+    if (life[i] > 0 && !(p.cullOffTop && y[i] < 0)) {
+      i++;
+      continue;
+    }
+    n--;
+    x[i] = x[n];
+    y[i] = y[n];
+    p.vx[i] = p.vx[n];
+    p.vy[i] = p.vy[n];
+    life[i] = life[n];
+    p.maxLife[i] = p.maxLife[n];
+    p.color[i] = p.color[n];
+    p.size[i] = p.size[n];
+  }
+  p.live = n;
+}
+
+// Disc row half-widths per radius; r*r + r - 1 - dy*dy reproduces the
+// fillCircle outline for the small radii particles use
+int8_t particleDiscSpans[PARTICLE_MAX_SIZE + 1][PARTICLE_MAX_SIZE * 2 + 1];
+bool particleDiscSpansReady = false;
+
+void buildParticleDiscSpans() {
+  for (int r = 1; r <= PARTICLE_MAX_SIZE; r++) {
+    for (int dy = -r; dy <= r; dy++) {
+      particleDiscSpans[r][dy + r] = (int8_t)fxSqrt((uint32_t)(r * r + r - 1 - dy * dy));
+    }
+  }
+  particleDiscSpansReady = true;
+}
+
+inline void particleSpan(uint16_t* buf, int16_t x0, int16_t x1, int16_t y, uint16_t color) {
+  if (y < 0 || y >= SCREEN_HEIGHT) return;
+  if (x0 < 0) x0 = 0;
+  if (x1 >= SCREEN_WIDTH) x1 = SCREEN_WIDTH - 1;
+  if (x0 > x1) return;
+  spanFill565(buf + (int32_t)y * SCREEN_WIDTH + x0, x1 - x0 + 1, color);
+}
+
+// Draws at (x + offsetX, y + offsetY), e.g. a negated camera position
+void particlesDraw(ParticlePool& p, int16_t offsetX = 0, int16_t offsetY = 0) {
+  extern FrameCanvas canvas;
+  uint16_t n = p.live;
+  if (n == 0) return;
+  if (!particleDiscSpansReady) buildParticleDiscSpans();
+
+  // Counting sort by drawn size, so each class is one run of identical spans
+  uint16_t start[PARTICLE_MAX_SIZE + 2] = {0};
+  for (uint16_t i = 0; i < n; i++) {
+    uint8_t s = (p.life[i] <= p.shrinkAt) ? 1 : p.size[i];
+    start[s + 1]++;
+  }
+  for (int s = 1; s <= PARTICLE_MAX_SIZE; s++) start[s + 1] += start[s];
+  uint16_t fill[PARTICLE_MAX_SIZE + 1];
+  memcpy(fill, start, sizeof(fill));
+  for (uint16_t i = 0; i < n; i++) {
+    uint8_t s = (p.life[i] <= p.shrinkAt) ? 1 : p.size[i];
+    p.order[fill[s]++] = i;
+  }
+
+  uint16_t* buf = canvas.getBuffer();
+  for (int s = 1; s <= PARTICLE_MAX_SIZE; s++) {
+    const int8_t* spans = particleDiscSpans[s];
+    for (uint16_t k = start[s]; k < start[s + 1]; k++) {
+      uint16_t i = p.order[k];
+      int16_t px = (int16_t)(p.x[i] >> 8) + offsetX;
+      int16_t py = (int16_t)(p.y[i] >> 8) + offsetY;
+      uint16_t color = p.color[i];
+      if (p.fade) color = mixColors(color, p.fadeTo, 255 - (uint32_t)p.life[i] * 255 / p.maxLife[i]);
+
+      if (p.shape == PARTICLE_SQUARE) {
+        for (int dy = 0; dy < s; dy++) particleSpan(buf, px, px + s - 1, py + dy, color);
+      } else {
+        for (int dy = -s; dy <= s; dy++) {
+          int8_t hw = spans[dy + s];
+          particleSpan(buf, px - hw, px + hw, py + dy, color);
+        }
+      }
+    }
+  }
+}
+
+#ifdef PARTICLE_BENCH
+// Build with -DPARTICLE_BENCH to print update and draw throughput for large
+// pools once from setup(). Uses the canvas buffer as scratch.
+void runParticleBenchmark() {
+  extern FrameCanvas canvas;
+  const uint16_t counts[] = {500, 2000, 4000};
+  const int frames = 60;
+
+  for (int shape = PARTICLE_SQUARE; shape <= PARTICLE_DISC; shape++) {
+    for (uint16_t count : counts) {
+      ParticlePool pool = makeParticlePool(count, (ParticleShape)shape, 0, false, shape == PARTICLE_DISC, 0x10A2);
+      for (uint16_t i = 0; i < count; i++) {
+        particleSpawn(pool, rngRange(rngParticles, 0, SCREEN_WIDTH), rngRange(rngParticles, 0, SCREEN_HEIGHT),
+                      rngFloat(rngParticles) * 2.0f - 1.0f, rngFloat(rngParticles) * 2.0f - 1.0f,
+                      frames + 1, 0xFFFF, rngRange(rngParticles, 1, 4));
+      }
+      if (pool.live != count) {
+        Serial.printf("[PARTICLE] %u particles: allocation failed\n", count);
+        particlePoolFree(pool);
+        continue;
+      }
+
+      unsigned long updateUs = 0, drawUs = 0;
+      for (int f = 0; f < frames; f++) {
+        unsigned long t = micros();
+        particlesUpdate(pool);
+        updateUs += micros() - t;
+        t = micros();
+        particlesDraw(pool);
+        drawUs += micros() - t;
+      }
+      Serial.printf("[PARTICLE] %-6s %5u: update %6.1f us/frame, draw %7.1f us/frame, %5.2f Mparticles/s\n",
+                    shape == PARTICLE_DISC ? "disc" : "square", count, (float)updateUs / frames,
+                    (float)drawUs / frames, (float)count * frames / (updateUs + drawUs));
+      particlePoolFree(pool);
+    }
+  }
+  memset(canvas.getBuffer(), 0, SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(uint16_t));
+}
+#endif
+
 // From https://github.com/spacehuhn/esp8266_deauther/blob/master/esp8266_deauther/functions.h
 // extern "C" int ieee80211_raw_frame_sanity_check(int32_t arg, int32_t arg2, int32_t arg3);
 extern "C" int wifi_send_pkt_freedom(uint8_t *buf, int len, bool sys_seq);
@@ -213,7 +997,842 @@ typedef struct {
 // Gunakan Hardware SPI untuk TFT untuk Performa Maksimal
 // Pin MOSI (11) dan SCLK (12) sudah sesuai dengan default VSPI hardware
 Adafruit_ST7789 tft = Adafruit_ST7789(TFT_CS, TFT_DC, TFT_RST);
-GFXcanvas16 canvas(SCREEN_WIDTH, SCREEN_HEIGHT);
+FrameCanvas canvas(SCREEN_WIDTH, SCREEN_HEIGHT);
+
+// Scope guard for network/JSON heavy work: parks the canvas in PSRAM so the
+// 108 KB it holds is free internal heap until the outermost guard ends.
+// If internal RAM is too fragmented to take it back right away,
+// restoreCanvasHeap() retries from loop().
+int canvasHeapReliefDepth = 0;
+
+struct CanvasHeapRelief {
+  CanvasHeapRelief() {
+    if (canvasHeapReliefDepth++ == 0 && psramFound()) canvas.relocate(true);
+  }
+  ~CanvasHeapRelief() {
+    if (--canvasHeapReliefDepth == 0) canvas.relocate(false);
+  }
+};
+
+void restoreCanvasHeap() {
+  static unsigned long lastTry = 0;
+  if (canvasHeapReliefDepth > 0 || !canvas.isInPsram()) return;
+  if (millis() - lastTry < 1000) return;
+  lastTry = millis();
+  canvas.relocate(false);
+}
+
+// ============ FRAME PROFILER ============
+// Scoped timing probes feeding per-state histograms. PROF_SCOPE(PROF_X) times
+// the rest of the enclosing block. Stats are kept for the PROF_STATE_SLOTS most
+// recently profiled states. Serial commands: 'p' dumps min/avg/p99/max, 'o'
+// toggles the on-screen overlay, 'r' resets. Off by default; build with
+// -DFRAME_PROFILER=1 to compile the probes in.
+#ifndef FRAME_PROFILER
+#define FRAME_PROFILER 0
+#endif
+#define PROF_STATE_SLOTS 4
+#define PROF_BUCKETS 64   // 0-4 ms in 125 us steps, then 1 ms steps to 36 ms
+
+enum ProfProbe {
+  PROF_FRAME,          // refreshCurrentScreen, whole frame on core 1
+  PROF_DRAW,           // the state's draw function
+  PROF_STATUS_BAR,
+  PROF_PUSH,           // pushCanvas: wait for the display task, diff, copy
+  PROF_SPI,            // display task transfer on core 0
+  PROF_LOGIC,          // update*Logic for the current game
+  PROF_RACE_BACKDROP,  // sky, clouds, mountains
+  PROF_RACE_ROAD,      // road scanline loop
+  PROF_RACE_SPRITES,   // scenery and cars
+  PROF_RACE_HUD,
+  PROF_INPUT,          // button edge to pollButtonEvents
+  PROF_COUNT
+};
+
+const char* const profProbeNames[PROF_COUNT] = {
+  "frame", "draw", "statusbar", "push", "spi", "logic",
+  "race.backdrop", "race.road", "race.sprites", "race.hud", "input"
+};
+
+struct ProbeStats {
+  uint32_t count;
+  uint64_t sum;
+  uint32_t minUs, maxUs;
+  uint16_t hist[PROF_BUCKETS];
+};
+
+struct ProfSlot {
+  int state;          // AppState, -1 = free
+  uint32_t lastUse;
+  ProbeStats probes[PROF_COUNT];
+};
+
+ProfSlot profSlots[PROF_STATE_SLOTS];
+ProfSlot* profActive = nullptr;
+int profState = -1;          // State the probes are attributed to
+uint32_t profTick = 0;
+bool showProfiler = false;
+volatile uint32_t profSpiMicros = 0;   // Written by the display task
+volatile bool profSpiReady = false;
+
+int profBucket(uint32_t us) {
+  if (us < 4000) return us / 125;
+  uint32_t b = 32 + (us - 4000) / 1000;
+  return b < PROF_BUCKETS ? b : PROF_BUCKETS - 1;
+}
+
+uint32_t profBucketLimit(int b) {
+  return b < 32 ? (b + 1) * 125 : 4000 + (b - 31) * 1000;
+}
+
+void profResetSlot(ProfSlot& slot, int state) {
+  memset(&slot, 0, sizeof(slot));
+  slot.state = state;
+  for (int p = 0; p < PROF_COUNT; p++) slot.probes[p].minUs = 0xFFFFFFFF;
+}
+
+void profReset() {
+  for (int i = 0; i < PROF_STATE_SLOTS; i++) profResetSlot(profSlots[i], -1);
+  profActive = nullptr;
+  profState = -1;
+}
+
+// Attribute following samples to `state`, recycling the least recent slot
+void profSetState(int state) {
+  profTick++;
+  if (profActive != nullptr && profState == state) {
+    profActive->lastUse = profTick;
+    return;
+  }
+  ProfSlot* victim = &profSlots[0];
+  for (int i = 0; i < PROF_STATE_SLOTS; i++) {
+    if (profSlots[i].state == state && profSlots[i].lastUse > 0) {
+      victim = &profSlots[i];
+      break;
+    }
+    if (profSlots[i].lastUse < victim->lastUse) victim = &profSlots[i];
+  }
+  if (victim->state != state || victim->lastUse == 0) profResetSlot(*victim, state);
+  victim->lastUse = profTick;
+  profActive = victim;
+  profState = state;
+}
+
+void probeRecord(ProbeStats& s, uint32_t us) {
+  s.count++;
+  s.sum += us;
+  if (us < s.minUs) s.minUs = us;
+  if (us > s.maxUs) s.maxUs = us;
+  int b = profBucket(us);
+  if (s.hist[b] == 0xFFFF) {
+    for (int i = 0; i < PROF_BUCKETS; i++) s.hist[i] >>= 1;  // keep shape, age old samples
+  }
+  s.hist[b]++;
+}
+
+void profRecord(uint8_t probe, uint32_t us) {
+  if (profActive == nullptr) return;
+  probeRecord(profActive->probes[probe], us);
+}
+
+uint32_t profPercentile(const ProbeStats& s, int pct) {
+  uint32_t total = 0;
+  for (int i = 0; i < PROF_BUCKETS; i++) total += s.hist[i];
+  if (total == 0) return 0;
+  uint32_t target = (total * pct + 99) / 100;
+  uint32_t acc = 0;
+  for (int i = 0; i < PROF_BUCKETS; i++) {
+    acc += s.hist[i];
+    if (acc >= target) return profBucketLimit(i);
+  }
+  return profBucketLimit(PROF_BUCKETS - 1);
+}
+
+struct ProfScope {
+  uint8_t probe;
+  uint32_t t0;
+  ProfScope(uint8_t p) : probe(p), t0(micros()) {}
+  ~ProfScope() { profRecord(probe, micros() - t0); }
+};
+
+// Consecutive sections of one function: each mark records the time since the
+// previous one
+struct ProfLap {
+  uint32_t t;
+  ProfLap() : t(micros()) {}
+  void mark(uint8_t probe) {
+    uint32_t now = micros();
+    profRecord(probe, now - t);
+    t = now;
+  }
+};
+
+#if FRAME_PROFILER
+#define PROF_CONCAT2(a, b) a##b
+#define PROF_CONCAT(a, b) PROF_CONCAT2(a, b)
+#define PROF_SCOPE(probe) ProfScope PROF_CONCAT(profScope_, __LINE__)(probe)
+#define PROF_LAP_BEGIN() ProfLap profLap
+#define PROF_LAP(probe) profLap.mark(probe)
+#else
+#define PROF_SCOPE(probe)
+#define PROF_LAP_BEGIN()
+#define PROF_LAP(probe)
+#endif
+
+void profDump() {
+  Serial.println(F("[prof] state probe            count    min    avg    p99    max (us)"));
+  for (int i = 0; i < PROF_STATE_SLOTS; i++) {
+    const ProfSlot& slot = profSlots[i];
+    if (slot.lastUse == 0) continue;
+    for (int p = 0; p < PROF_COUNT; p++) {
+      const ProbeStats& s = slot.probes[p];
+      if (s.count == 0) continue;
+      Serial.printf("[prof] %5d %-14s %7lu %6lu %6lu %6lu %6lu\n", slot.state, profProbeNames[p],
+                    (unsigned long)s.count, (unsigned long)s.minUs, (unsigned long)(s.sum / s.count),
+                    (unsigned long)profPercentile(s, 99), (unsigned long)s.maxUs);
+    }
+  }
+}
+
+// Bottom-left panel with avg/p99 of the current state's probes
+void drawProfilerOverlay() {
+  if (profActive == nullptr) return;
+  int lines = 0;
+  for (int p = 0; p < PROF_COUNT; p++) if (profActive->probes[p].count > 0) lines++;
+  if (lines == 0) return;
+
+  int h = lines * 9 + 4;
+  int y = SCREEN_HEIGHT - h;
+  fillRectAlpha(0, y, 150, h, 0x0000, 200);
+  canvas.setTextSize(1);
+  canvas.setTextColor(0xFFFF);
+  y += 2;
+  for (int p = 0; p < PROF_COUNT; p++) {
+    const ProbeStats& s = profActive->probes[p];
+    if (s.count == 0) continue;
+    char line[32];
+    snprintf(line, sizeof(line), "%-13s%5lu %5lu", profProbeNames[p],
+             (unsigned long)(s.sum / s.count), (unsigned long)profPercentile(s, 99));
+    canvas.setCursor(2, y);
+    canvas.print(line);
+    y += 9;
+  }
+}
+
+// Called by handleSerialCommands() for bytes it doesn't handle itself
+void handleProfilerCommand(char c) {
+  switch (c) {
+    case 'p': profDump(); break;
+    case 'o': showProfiler = !showProfiler; break;
+    case 'r': profReset(); Serial.println(F("[prof] reset")); break;
+  }
+}
+
+// ============ DISPLAY PIPELINE (DIRTY TILES, DUAL CORE) ============
+// `canvas` is the back buffer that every screen renders into. The front buffer
+// (PSRAM) holds what the panel shows once the display task has caught up.
+// pushCanvas() diffs back against front in 16x16 tiles, copies the changed
+// tiles over and hands the list of windows to a task pinned to the other
+// core, so loop() renders the next frame while SPI is still busy.
+#define DIRTY_TILE_SIZE 16
+#define DIRTY_TILES_X ((SCREEN_WIDTH + DIRTY_TILE_SIZE - 1) / DIRTY_TILE_SIZE)
+#define DIRTY_TILES_Y ((SCREEN_HEIGHT + DIRTY_TILE_SIZE - 1) / DIRTY_TILE_SIZE)
+#define DIRTY_FULL_PUSH_PERCENT 75 // Above this, one full window is cheaper
+#define DISPLAY_TASK_CORE 0        // loop() runs on core 1
+#define DISPLAY_MAX_WINDOWS (DIRTY_TILES_Y * ((DIRTY_TILES_X + 1) / 2))
+
+struct DisplayWindow {
+  int16_t x, y, w, h;
+};
+
+struct DisplayJob {
+  DisplayWindow windows[DISPLAY_MAX_WINDOWS];
+  int count;
+  int16_t dx, dy; // Screen shake offset, only used with a single full window
+};
+
+uint16_t* frontBuffer = nullptr; // Panel contents once the current job is sent
+bool frontBufferValid = false;
+uint32_t dirtyTileRows[DIRTY_TILES_Y]; // Bit tx set = tile (tx, ty) changed
+DisplayJob displayJob;
+TaskHandle_t displayTaskHandle = nullptr;
+SemaphoreHandle_t displayIdle = nullptr; // Given while no job is in flight
+
+int16_t frameShakeX = 0, frameShakeY = 0; // Offset for the next pushCanvas() from refreshCurrentScreen()
+
+uint32_t displayFrameCount = 0;  // pushCanvas() calls since boot
+bool displayScrollFrame = false; // Next push is a scroll step, see SCROLL VIEWPORT
+
+uint32_t lastPushBytes = 0;     // Bytes sent by the last push
+uint32_t perfPushBytes = 0;     // Accumulated over the current second
+uint32_t perfPushCount = 0;
+uint32_t perfBytesPerFrame = 0; // Average of the last second, for the FPS overlay
+
+void displayTask(void* param) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    uint32_t t0 = micros();
+
+    if (displayJob.dx != 0 || displayJob.dy != 0) {
+      // drawRGBBitmap clips and opens its own SPI transaction
+      tft.drawRGBBitmap(displayJob.dx, displayJob.dy, frontBuffer, SCREEN_WIDTH, SCREEN_HEIGHT);
+    } else {
+      tft.startWrite();
+      for (int i = 0; i < displayJob.count; i++) {
+        const DisplayWindow& win = displayJob.windows[i];
+        tft.setAddrWindow(win.x, win.y, win.w, win.h);
+        if (win.x == 0 && win.w == SCREEN_WIDTH) {
+          // Full-width rows are contiguous in memory, send them in one go
+          tft.writePixels(frontBuffer + (int32_t)win.y * SCREEN_WIDTH, (uint32_t)win.w * win.h);
+        } else {
+          for (int16_t j = win.y; j < win.y + win.h; j++) {
+            tft.writePixels(frontBuffer + (int32_t)j * SCREEN_WIDTH + win.x, win.w);
+          }
+        }
+      }
+      tft.endWrite();
+    }
+
+    profSpiMicros = micros() - t0;
+    profSpiReady = true;
+    xSemaphoreGive(displayIdle);
+  }
+}
+
+void initDisplayPipeline() {
+  if (frontBuffer == nullptr) {
+    // Without PSRAM a 108 KB front buffer is too expensive for internal heap;
+    // pushCanvas() then sends full frames synchronously from the canvas.
+    frontBuffer = (uint16_t*)ps_malloc(SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(uint16_t));
+  }
+  if (frontBuffer != nullptr && displayTaskHandle == nullptr) {
+    displayIdle = xSemaphoreCreateBinary();
+    xSemaphoreGive(displayIdle);
+    xTaskCreatePinnedToCore(displayTask, "display", 4096, nullptr, 1, &displayTaskHandle, DISPLAY_TASK_CORE);
+  }
+  frontBufferValid = false;
+}
+
+// Call after anything writes to the panel without going through pushCanvas()
+void invalidateDisplay() {
+  frontBufferValid = false;
+}
+
+int collectDirtyTiles() {
+  const uint16_t* buf = canvas.getBuffer();
+  const uint32_t fullRow = (DIRTY_TILES_X >= 32) ? 0xFFFFFFFFUL : ((1UL << DIRTY_TILES_X) - 1);
+  int count = 0;
+
+  for (int ty = 0; ty < DIRTY_TILES_Y; ty++) {
+    uint32_t mask = 0;
+    int y0 = ty * DIRTY_TILE_SIZE;
+    int y1 = min(y0 + DIRTY_TILE_SIZE, SCREEN_HEIGHT);
+    for (int y = y0; y < y1 && mask != fullRow; y++) {
+      const uint16_t* a = buf + (int32_t)y * SCREEN_WIDTH;
+      const uint16_t* b = frontBuffer + (int32_t)y * SCREEN_WIDTH;
+      for (int tx = 0; tx < DIRTY_TILES_X; tx++) {
+        if (mask & (1UL << tx)) continue;
+        int x0 = tx * DIRTY_TILE_SIZE;
+        int w = min(DIRTY_TILE_SIZE, SCREEN_WIDTH - x0);
+        if (memcmp(a + x0, b + x0, w * sizeof(uint16_t)) != 0) mask |= (1UL << tx);
+      }
+    }
+    dirtyTileRows[ty] = mask;
+    count += __builtin_popcount(mask);
+  }
+  return count;
+}
+
+// Copies a window of the canvas into the front buffer and queues it
+void queueDisplayWindow(int16_t x, int16_t y, int16_t w, int16_t h) {
+  const uint16_t* buf = canvas.getBuffer();
+  if (x == 0 && w == SCREEN_WIDTH) {
+    memcpy(frontBuffer + (int32_t)y * SCREEN_WIDTH, buf + (int32_t)y * SCREEN_WIDTH, (size_t)w * h * sizeof(uint16_t));
+  } else {
+    for (int16_t j = y; j < y + h; j++) {
+      memcpy(frontBuffer + (int32_t)j * SCREEN_WIDTH + x, buf + (int32_t)j * SCREEN_WIDTH + x, w * sizeof(uint16_t));
+    }
+  }
+  DisplayWindow& win = displayJob.windows[displayJob.count++];
+  win.x = x; win.y = y; win.w = w; win.h = h;
+  lastPushBytes += (uint32_t)w * h * sizeof(uint16_t);
+}
+
+// Hands the finished canvas to the display. Blocks only while the previous
+// frame is still being sent. A non-zero dx/dy (screen shake) sends the whole
+// shifted frame and forces the next push to be a full one.
+void pushCanvas(int16_t dx = 0, int16_t dy = 0) {
+  PROF_SCOPE(PROF_PUSH);
+  lastPushBytes = 0;
+
+  if (displayTaskHandle == nullptr) {
+    tft.drawRGBBitmap(dx, dy, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
+    lastPushBytes = (uint32_t)SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(uint16_t);
+  } else {
+    xSemaphoreTake(displayIdle, portMAX_DELAY);
+    if (profSpiReady) {
+      profSpiReady = false;
+      profRecord(PROF_SPI, profSpiMicros);
+    }
+    displayJob.count = 0;
+    displayJob.dx = dx;
+    displayJob.dy = dy;
+
+    bool fullPush = !frontBufferValid || dx != 0 || dy != 0;
+    int dirty = 0;
+    if (!fullPush) {
+      dirty = collectDirtyTiles();
+      // A scroll step rewrites most tiles but never the fixed header rows
+      fullPush = !displayScrollFrame && dirty * 100 >= DIRTY_TILES_X * DIRTY_TILES_Y * DIRTY_FULL_PUSH_PERCENT;
+    }
+
+    if (fullPush) {
+      queueDisplayWindow(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    } else if (dirty > 0) {
+      for (int ty = 0; ty < DIRTY_TILES_Y; ty++) {
+        uint32_t mask = dirtyTileRows[ty];
+        int y0 = ty * DIRTY_TILE_SIZE;
+        int h = min(DIRTY_TILE_SIZE, SCREEN_HEIGHT - y0);
+        int tx = 0;
+        while (mask != 0 && tx < DIRTY_TILES_X) {
+          if (!(mask & (1UL << tx))) { tx++; continue; }
+          int runStart = tx;
+          while (tx < DIRTY_TILES_X && (mask & (1UL << tx))) {
+            mask &= ~(1UL << tx);
+            tx++;
+          }
+          int x0 = runStart * DIRTY_TILE_SIZE;
+          int x1 = min(tx * DIRTY_TILE_SIZE, SCREEN_WIDTH);
+          queueDisplayWindow(x0, y0, x1 - x0, h);
+        }
+      }
+    }
+    frontBufferValid = (dx == 0 && dy == 0);
+
+    if (displayJob.count > 0) {
+      xTaskNotifyGive(displayTaskHandle);
+    } else {
+      xSemaphoreGive(displayIdle);
+    }
+  }
+
+  perfPushBytes += lastPushBytes;
+  perfPushCount++;
+  displayFrameCount++;
+  displayScrollFrame = false;
+}
+
+// ============ GLYPH ATLAS ============
+// Span-based text renderer for the long-form viewers. The built-in 5x7 font is
+// rasterized once into row bitmaps in its CP437 layout, so the code page's
+// accented Latin letters and symbols come along. Glyphs are trimmed to their
+// inked columns for proportional advances and drawn as spans straight into the
+// canvas buffer. UTF-8 input is decoded and mapped onto the atlas: Latin-1 and
+// Latin Extended-A letters to their CP437 glyph or base letter, typographic
+// punctuation to ASCII, common emoji to the nearest CP437 symbol and anything
+// else to a small box. From size 2 up, the inner corners of diagonal strokes
+// are filled with blended pixels.
+#define GLYPH_COUNT 256
+#define GLYPH_ROWS 8
+#define GLYPH_NONE -1           // Zero-width code point (joiners, variation selectors)
+#define GLYPH_REPLACEMENT 0xFE  // CP437 small square
+#define GLYPH_ELLIPSIS 0x00     // Blank in CP437; the atlas puts "..." there
+#define GLYPH_SPACE_ADVANCE 4
+
+struct GlyphMapEntry {
+  uint16_t cp;
+  uint8_t glyph;
+};
+
+// Sorted by code point
+const GlyphMapEntry glyphMap[] = {
+  {0x00A0, ' '}, {0x00A1, 0xAD}, {0x00A2, 0x9B}, {0x00A3, 0x9C}, {0x00A5, 0x9D}, {0x00A7, 0x15},
+  {0x00A9, 'c'}, {0x00AA, 0xA6}, {0x00AB, 0xAE}, {0x00AC, 0xAA}, {0x00AE, 'r'}, {0x00B0, 0xF8},
+  {0x00B1, 0xF1}, {0x00B2, 0xFD}, {0x00B5, 0xE6}, {0x00B6, 0x14}, {0x00B7, 0xFA}, {0x00BA, 0xA7},
+  {0x00BB, 0xAF}, {0x00BC, 0xAC}, {0x00BD, 0xAB}, {0x00BF, 0xA8}, {0x00C0, 'A'}, {0x00C1, 'A'},
+  {0x00C2, 'A'}, {0x00C3, 'A'}, {0x00C4, 0x8E}, {0x00C5, 0x8F}, {0x00C6, 0x92}, {0x00C7, 0x80},
+  {0x00C8, 'E'}, {0x00C9, 0x90}, {0x00CA, 'E'}, {0x00CB, 'E'}, {0x00CC, 'I'}, {0x00CD, 'I'},
+  {0x00CE, 'I'}, {0x00CF, 'I'}, {0x00D0, 'D'}, {0x00D1, 0xA5}, {0x00D2, 'O'}, {0x00D3, 'O'},
+  {0x00D4, 'O'}, {0x00D5, 'O'}, {0x00D6, 0x99}, {0x00D7, 'x'}, {0x00D8, 'O'}, {0x00D9, 'U'},
+  {0x00DA, 'U'}, {0x00DB, 'U'}, {0x00DC, 0x9A}, {0x00DD, 'Y'}, {0x00DE, 'P'}, {0x00DF, 0xE1},
+  {0x00E0, 0x85}, {0x00E1, 0xA0}, {0x00E2, 0x83}, {0x00E3, 'a'}, {0x00E4, 0x84}, {0x00E5, 0x86},
+  {0x00E6, 0x91}, {0x00E7, 0x87}, {0x00E8, 0x8A}, {0x00E9, 0x82}, {0x00EA, 0x88}, {0x00EB, 0x89},
+  {0x00EC, 0x8D}, {0x00ED, 0xA1}, {0x00EE, 0x8C}, {0x00EF, 0x8B}, {0x00F0, 'd'}, {0x00F1, 0xA4},
+  {0x00F2, 0x95}, {0x00F3, 0xA2}, {0x00F4, 0x93}, {0x00F5, 'o'}, {0x00F6, 0x94}, {0x00F7, 0xF6},
+  {0x00F8, 'o'}, {0x00F9, 0x97}, {0x00FA, 0xA3}, {0x00FB, 0x96}, {0x00FC, 0x81}, {0x00FD, 'y'},
+  {0x00FE, 'p'}, {0x00FF, 0x98}, {0x0100, 'A'}, {0x0101, 'a'}, {0x0102, 'A'}, {0x0103, 'a'},
+  {0x0104, 'A'}, {0x0105, 'a'}, {0x0106, 'C'}, {0x0107, 'c'}, {0x0108, 'C'}, {0x0109, 'c'},
+  {0x010A, 'C'}, {0x010B, 'c'}, {0x010C, 'C'}, {0x010D, 'c'}, {0x010E, 'D'}, {0x010F, 'd'},
+  {0x0110, 'D'}, {0x0111, 'd'}, {0x0112, 'E'}, {0x0113, 'e'}, {0x0114, 'E'}, {0x0115, 'e'},
+  {0x0116, 'E'}, {0x0117, 'e'}, {0x0118, 'E'}, {0x0119, 'e'}, {0x011A, 'E'}, {0x011B, 'e'},
+  {0x011C, 'G'}, {0x011D, 'g'}, {0x011E, 'G'}, {0x011F, 'g'}, {0x0120, 'G'}, {0x0121, 'g'},
+  {0x0122, 'G'}, {0x0123, 'g'}, {0x0124, 'H'}, {0x0125, 'h'}, {0x0126, 'H'}, {0x0127, 'h'},
+  {0x0128, 'I'}, {0x0129, 'i'}, {0x012A, 'I'}, {0x012B, 'i'}, {0x012C, 'I'}, {0x012D, 'i'},
+  {0x012E, 'I'}, {0x012F, 'i'}, {0x0130, 'I'}, {0x0131, 'i'}, {0x0132, 'J'}, {0x0133, 'j'},
+  {0x0134, 'J'}, {0x0135, 'j'}, {0x0136, 'K'}, {0x0137, 'k'}, {0x0138, 'k'}, {0x0139, 'L'},
+  {0x013A, 'l'}, {0x013B, 'L'}, {0x013C, 'l'}, {0x013D, 'L'}, {0x013E, 'l'}, {0x013F, 'L'},
+  {0x0140, 'l'}, {0x0141, 'L'}, {0x0142, 'l'}, {0x0143, 'N'}, {0x0144, 'n'}, {0x0145, 'N'},
+  {0x0146, 'n'}, {0x0147, 'N'}, {0x0148, 'n'}, {0x0149, 'n'}, {0x014A, 'N'}, {0x014B, 'n'},
+  {0x014C, 'O'}, {0x014D, 'o'}, {0x014E, 'O'}, {0x014F, 'o'}, {0x0150, 'O'}, {0x0151, 'o'},
+  {0x0152, 'O'}, {0x0153, 'o'}, {0x0154, 'R'}, {0x0155, 'r'}, {0x0156, 'R'}, {0x0157, 'r'},
+  {0x0158, 'R'}, {0x0159, 'r'}, {0x015A, 'S'}, {0x015B, 's'}, {0x015C, 'S'}, {0x015D, 's'},
+  {0x015E, 'S'}, {0x015F, 's'}, {0x0160, 'S'}, {0x0161, 's'}, {0x0162, 'T'}, {0x0163, 't'},
+  {0x0164, 'T'}, {0x0165, 't'}, {0x0166, 'T'}, {0x0167, 't'}, {0x0168, 'U'}, {0x0169, 'u'},
+  {0x016A, 'U'}, {0x016B, 'u'}, {0x016C, 'U'}, {0x016D, 'u'}, {0x016E, 'U'}, {0x016F, 'u'},
+  {0x0170, 'U'}, {0x0171, 'u'}, {0x0172, 'U'}, {0x0173, 'u'}, {0x0174, 'W'}, {0x0175, 'w'},
+  {0x0176, 'Y'}, {0x0177, 'y'}, {0x0178, 'Y'}, {0x0179, 'Z'}, {0x017A, 'z'}, {0x017B, 'Z'},
+  {0x017C, 'z'}, {0x017D, 'Z'}, {0x017E, 'z'}, {0x017F, 's'}, {0x0192, 0x9F}, {0x0393, 0xE2},
+  {0x0398, 0xE9}, {0x03A3, 0xE4}, {0x03A6, 0xE8}, {0x03A9, 0xEA}, {0x03B1, 0xE0}, {0x03B4, 0xEB},
+  {0x03B5, 0xEE}, {0x03C0, 0xE3}, {0x03C3, 0xE5}, {0x03C4, 0xE7}, {0x03C6, 0xED}, {0x2010, '-'},
+  {0x2011, '-'}, {0x2013, '-'}, {0x2014, '-'}, {0x2018, '\''}, {0x2019, '\''}, {0x201A, '\''},
+  {0x201C, '"'}, {0x201D, '"'}, {0x201E, '"'}, {0x2022, 0x07}, {0x2026, 0x00}, {0x2032, '\''},
+  {0x2033, '"'}, {0x203C, 0x13}, {0x207F, 0xFC}, {0x20A7, 0x9E}, {0x20AC, 'E'}, {0x2190, 0x1B},
+  {0x2191, 0x18}, {0x2192, 0x1A}, {0x2193, 0x19}, {0x2194, 0x1D}, {0x2195, 0x12}, {0x2212, '-'},
+  {0x2219, 0xF9}, {0x221A, 0xFB}, {0x221E, 0xEC}, {0x2229, 0xEF}, {0x2248, 0xF7}, {0x2261, 0xF0},
+  {0x2264, 0xF3}, {0x2265, 0xF2}, {0x2302, 0x7F}, {0x2310, 0xA9}, {0x2320, 0xF4}, {0x2321, 0xF5},
+  {0x2500, 0xC4}, {0x2502, 0xB3}, {0x250C, 0xDA}, {0x2510, 0xBF}, {0x2514, 0xC0}, {0x2518, 0xD9},
+  {0x251C, 0xC3}, {0x2524, 0xB4}, {0x252C, 0xC2}, {0x2534, 0xC1}, {0x253C, 0xC5}, {0x2550, 0xCD},
+  {0x2551, 0xBA}, {0x2552, 0xD5}, {0x2553, 0xD6}, {0x2554, 0xC9}, {0x2555, 0xB8}, {0x2556, 0xB7},
+  {0x2557, 0xBB}, {0x2558, 0xD4}, {0x2559, 0xD3}, {0x255A, 0xC8}, {0x255B, 0xBE}, {0x255C, 0xBD},
+  {0x255D, 0xBC}, {0x255E, 0xC6}, {0x255F, 0xC7}, {0x2560, 0xCC}, {0x2561, 0xB5}, {0x2562, 0xB6},
+  {0x2563, 0xB9}, {0x2564, 0xD1}, {0x2565, 0xD2}, {0x2566, 0xCB}, {0x2567, 0xCF}, {0x2568, 0xD0},
+  {0x2569, 0xCA}, {0x256A, 0xD8}, {0x256B, 0xD7}, {0x256C, 0xCE}, {0x2580, 0xDF}, {0x2584, 0xDC},
+  {0x2588, 0xDB}, {0x258C, 0xDD}, {0x2590, 0xDE}, {0x2591, 0xB0}, {0x2592, 0xB1}, {0x2593, 0xB2},
+  {0x25A0, 0xFE}, {0x25B2, 0x1E}, {0x25B6, 0x10}, {0x25BA, 0x10}, {0x25BC, 0x1F}, {0x25C0, 0x11},
+  {0x25C4, 0x11}, {0x25CF, 0x07}, {0x2600, 0x0F}, {0x263A, 0x01}, {0x263B, 0x02}, {0x263C, 0x0F},
+  {0x2660, 0x06}, {0x2663, 0x05}, {0x2665, 0x03}, {0x2666, 0x04}, {0x266A, 0x0D}, {0x266B, 0x0E},
+  {0x2705, 0xFB}, {0x2713, 0xFB}, {0x2714, 0xFB}, {0x2716, 'x'}, {0x2717, 'x'}, {0x2728, '*'},
+  {0x274C, 'x'}, {0x2764, 0x03}, {0x27A1, 0x1A}, {0x2B05, 0x1B}, {0x2B06, 0x18}, {0x2B07, 0x19},
+  {0x2B50, '*'}
+};
+
+struct GlyphAtlas {
+  uint8_t rows[GLYPH_COUNT][GLYPH_ROWS]; // Bit c = inked column c, left-trimmed
+  uint8_t advance[GLYPH_COUNT];          // Inked width plus one column gap
+  uint16_t cornerStart[GLYPH_COUNT + 1]; // Range of each glyph in `corners`
+  std::vector<uint8_t> corners;          // x | y << 3 | corner << 6
+  bool ready = false;
+};
+
+GlyphAtlas glyphAtlas;
+
+void buildGlyphAtlas() {
+  GFXcanvas1 cell(6, GLYPH_ROWS);
+  cell.cp437(true);
+  glyphAtlas.corners.clear();
+
+  for (int g = 0; g < GLYPH_COUNT; g++) {
+    cell.fillScreen(0);
+    if (g == GLYPH_ELLIPSIS) {
+      cell.drawPixel(0, 6, 1);
+      cell.drawPixel(2, 6, 1);
+      cell.drawPixel(4, 6, 1);
+    } else {
+      cell.drawChar(0, 0, g, 1, 0, 1);
+    }
+
+    uint8_t used = 0;
+    uint8_t* rows = glyphAtlas.rows[g];
+    for (int y = 0; y < GLYPH_ROWS; y++) {
+      rows[y] = 0;
+      for (int x = 0; x < 5; x++) {
+        if (cell.getPixel(x, y)) rows[y] |= 1 << x;
+      }
+      used |= rows[y];
+    }
+    glyphAtlas.cornerStart[g] = glyphAtlas.corners.size();
+    if (used == 0) {
+      glyphAtlas.advance[g] = GLYPH_SPACE_ADVANCE;
+      continue;
+    }
+    int first = __builtin_ctz(used);
+    int width = 32 - __builtin_clz(used) - first;
+    for (int y = 0; y < GLYPH_ROWS; y++) rows[y] >>= first;
+    glyphAtlas.advance[g] = width + 1;
+
+    // Empty cells whose two neighbours meeting at a corner are inked while the
+    // cell diagonally across is not: the step of a diagonal stroke
+    auto ink = [&](int x, int y) {
+      return x >= 0 && x < width && y >= 0 && y < GLYPH_ROWS && (rows[y] >> x & 1);
+    };
+    for (int y = 0; y < GLYPH_ROWS; y++) {
+      for (int x = 0; x < width; x++) {
+        if (ink(x, y)) continue;
+        for (int corner = 0; corner < 4; corner++) {
+          int dx = (corner & 1) ? 1 : -1;
+          int dy = (corner & 2) ? 1 : -1;
+          if (ink(x + dx, y) && ink(x, y + dy) && !ink(x + dx, y + dy)) {
+            glyphAtlas.corners.push_back(x | y << 3 | corner << 6);
+          }
+        }
+      }
+    }
+  }
+  glyphAtlas.cornerStart[GLYPH_COUNT] = glyphAtlas.corners.size();
+  glyphAtlas.ready = true;
+}
+
+// Next code point of a UTF-8 run; malformed bytes decode as U+FFFD one at a time
+uint32_t utf8Next(const char*& p, const char* end) {
+  uint8_t b = *p++;
+  if (b < 0x80) return b;
+  int extra = (b >= 0xF0) ? 3 : (b >= 0xE0) ? 2 : (b >= 0xC0) ? 1 : -1;
+  if (extra < 0 || end - p < extra) return 0xFFFD;
+  uint32_t cp = b & (0x3F >> extra);
+  for (int i = 0; i < extra; i++) {
+    uint8_t c = (uint8_t)p[i];
+    if ((c & 0xC0) != 0x80) return 0xFFFD;
+    cp = (cp << 6) | (c & 0x3F);
+  }
+  p += extra;
+  return cp;
+}
+
+int16_t glyphForCodepoint(uint32_t cp) {
+  if (cp < 0x80) {
+    if (cp == '\t') return ' ';
+    return (cp < 0x20 || cp == 0x7F) ? GLYPH_NONE : (int16_t)cp;
+  }
+  if ((cp >= 0x0300 && cp <= 0x036F) || (cp >= 0x200B && cp <= 0x200F) || cp == 0x2060 ||
+      cp == 0x20E3 || (cp >= 0xFE00 && cp <= 0xFE0F) || cp == 0xFEFF ||
+      (cp >= 0x1F3FB && cp <= 0x1F3FF)) {
+    return GLYPH_NONE;
+  }
+  if (cp > 0xFFFF) {
+    if ((cp >= 0x1F600 && cp <= 0x1F64F) || (cp >= 0x1F910 && cp <= 0x1F92F) ||
+        (cp >= 0x1F970 && cp <= 0x1F97F)) return 0x01; // Faces
+    if ((cp >= 0x1F493 && cp <= 0x1F49F) || cp == 0x1F9E1) return 0x03; // Hearts
+    if (cp == 0x1F3B5 || cp == 0x1F3B6) return 0x0E;
+    if (cp == 0x1F31E) return 0x0F;
+    if (cp == 0x1F31F) return '*';
+    return GLYPH_REPLACEMENT;
+  }
+
+  size_t lo = 0, hi = sizeof(glyphMap) / sizeof(glyphMap[0]);
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (glyphMap[mid].cp < cp) lo = mid + 1;
+    else hi = mid;
+  }
+  if (lo < sizeof(glyphMap) / sizeof(glyphMap[0]) && glyphMap[lo].cp == cp) return glyphMap[lo].glyph;
+  return GLYPH_REPLACEMENT;
+}
+
+// Width in pixels of n bytes of UTF-8 at the given size
+int32_t textRunWidth(const char* s, uint32_t n, uint8_t size) {
+  if (!glyphAtlas.ready) buildGlyphAtlas();
+  const char* end = s + n;
+  int32_t w = 0;
+  while (s < end) {
+    int16_t g = glyphForCodepoint(utf8Next(s, end));
+    if (g != GLYPH_NONE) w += glyphAtlas.advance[g];
+  }
+  return w * size;
+}
+
+// Rows outside [clipY0, clipY1) are left alone, so a glyph straddling the
+// edge of a scrolled band doesn't blend its corners twice onto kept rows.
+// The clip must lie within the screen.
+void drawGlyph(int16_t x, int16_t y, uint8_t g, uint8_t size, uint16_t color,
+               int16_t clipY0 = 0, int16_t clipY1 = SCREEN_HEIGHT) {
+  uint16_t* buf = canvas.getBuffer();
+  const uint8_t* rows = glyphAtlas.rows[g];
+  for (int r = 0; r < GLYPH_ROWS; r++) {
+    uint32_t bits = rows[r];
+    while (bits) {
+      int c0 = __builtin_ctz(bits);
+      int len = __builtin_ctz(~(bits >> c0));
+      bits &= ~(((1u << len) - 1) << c0);
+
+      int16_t sx = x + c0 * size, sy = y + r * size;
+      int16_t w = len * size, h = size;
+      if (!clipToScreen(sx, sy, w, h)) continue;
+      if (sy < clipY0) { h -= clipY0 - sy; sy = clipY0; }
+      if (sy + h > clipY1) h = clipY1 - sy;
+      if (h <= 0) continue;
+      uint16_t* row = buf + (int32_t)sy * SCREEN_WIDTH + sx;
+      for (int16_t j = 0; j < h; j++, row += SCREEN_WIDTH) spanFill565(row, w, color);
+    }
+  }
+
+  if (size < 2) return;
+  for (uint16_t k = glyphAtlas.cornerStart[g]; k < glyphAtlas.cornerStart[g + 1]; k++) {
+    uint8_t c = glyphAtlas.corners[k];
+    int16_t bx = x + (c & 7) * size;
+    int16_t by = y + (c >> 3 & 7) * size;
+    bool right = c & 0x40, bottom = c & 0x80;
+    for (int j = 0; j < size; j++) {
+      for (int i = 0; i < size; i++) {
+        int d = (right ? size - 1 - i : i) + (bottom ? size - 1 - j : j);
+        if (d >= size - 1) continue;
+        int16_t px = bx + i, py = by + j;
+        if (px < 0 || px >= SCREEN_WIDTH || py < clipY0 || py >= clipY1) continue;
+        spanBlend565(buf + (int32_t)py * SCREEN_WIDTH + px, 1, color, 255 * (size - 1 - d) / size);
+      }
+    }
+  }
+}
+
+// Draw n bytes of UTF-8 with the top-left at (x, y), touching only rows in
+// [clipY0, clipY1); returns the x after it
+int16_t drawTextRun(int16_t x, int16_t y, const char* s, uint32_t n, uint8_t size, uint16_t color,
+                    int16_t clipY0 = 0, int16_t clipY1 = SCREEN_HEIGHT) {
+  if (!glyphAtlas.ready) buildGlyphAtlas();
+  if (y >= clipY1 || y + GLYPH_ROWS * size <= clipY0) return x + textRunWidth(s, n, size);
+  const char* end = s + n;
+  while (s < end) {
+    int16_t g = glyphForCodepoint(utf8Next(s, end));
+    if (g == GLYPH_NONE) continue;
+    if (x < SCREEN_WIDTH && g != ' ') drawGlyph(x, y, g, size, color, clipY0, clipY1);
+    x += glyphAtlas.advance[g] * size;
+  }
+  return x;
+}
+
+// ============ TEXT LAYOUT ============
+// Word wrap computed once per text and kept as line records (byte offset,
+// length, y). Viewers redraw by printing only the lines inside their window.
+// Wrapping runs incrementally: each sync lays out at most TEXT_LAYOUT_BUDGET
+// bytes beyond what the visible window needs, so a long answer never stalls a
+// frame and the rest is picked up on the following frames.
+#define TEXT_LAYOUT_BUDGET 1024
+
+// Layouts are keyed on a version instead of rehashing kilobytes of text per
+// frame. Bump this wherever aiResponse, fileContentToView or currentArticle
+// is assigned.
+uint32_t textVersion = 0;
+
+struct TextLine {
+  uint32_t offset;
+  uint16_t len;
+  int32_t y;
+};
+
+struct TextLayout {
+  std::vector<TextLine> lines;
+  uint32_t version = 0;
+  uint32_t length = 0;
+  uint8_t textSize = 0;
+  int16_t maxWidth = 0;
+  int16_t lineHeight = 0;
+  bool breakOnNewline = false;
+
+  // Wrap state between incremental syncs
+  uint32_t pos = 0;
+  uint32_t lineStart = 0;
+  int32_t cursorX = 0;
+  int32_t y = 0;
+  bool done = false;
+  uint32_t layoutMicros = 0;
+};
+
+uint32_t textLayoutHash(const String& text) {
+  uint32_t h = 2166136261u;  // FNV-1a
+  const char* s = text.c_str();
+  for (unsigned int i = 0; i < text.length(); i++) {
+    h = (h ^ (uint8_t)s[i]) * 16777619u;
+  }
+  return h;
+}
+
+// Make `L` describe `text` wrapped to maxWidth pixels, laid out at least down
+// to needY (relative to the first line). Restarts when the version, length or
+// metrics change; short transient strings pass textLayoutHash(text).
+void textLayoutSync(TextLayout& L, const String& text, uint32_t version, uint8_t textSize, int16_t maxWidth,
+                    int16_t lineHeight, bool breakOnNewline, int32_t needY) {
+  if (version != L.version || text.length() != L.length || textSize != L.textSize ||
+      maxWidth != L.maxWidth || lineHeight != L.lineHeight || breakOnNewline != L.breakOnNewline) {
+    L.lines.clear();
+    L.version = version;
+    L.length = text.length();
+    L.textSize = textSize;
+    L.maxWidth = maxWidth;
+    L.lineHeight = lineHeight;
+    L.breakOnNewline = breakOnNewline;
+    L.pos = 0;
+    L.lineStart = 0;
+    L.cursorX = 0;
+    L.y = 0;
+    L.done = false;
+    L.layoutMicros = 0;
+  }
+  if (L.done) return;
+
+  unsigned long t0 = micros();
+  const char* s = text.c_str();
+  uint32_t n = L.length;
+  int32_t spaceW = GLYPH_SPACE_ADVANCE * textSize;
+  uint32_t budgetEnd = L.pos + TEXT_LAYOUT_BUDGET;
+
+  while (L.pos < n && (L.pos < budgetEnd || L.y <= needY)) {
+    uint32_t j = L.pos;
+    while (j < n && s[j] != ' ' && !(breakOnNewline && s[j] == '\n')) j++;
+
+    int32_t wordW = textRunWidth(s + L.pos, j - L.pos, textSize);
+    if (L.cursorX > 0 && L.cursorX + wordW > maxWidth) {
+      L.lines.push_back({L.lineStart, (uint16_t)(L.pos - 1 - L.lineStart), L.y});
+      L.y += lineHeight;
+      L.cursorX = 0;
+      L.lineStart = L.pos;
+    }
+    L.cursorX += wordW + spaceW;
+
+    if (j < n && s[j] == '\n') {
+      L.lines.push_back({L.lineStart, (uint16_t)(j - L.lineStart), L.y});
+      L.y += lineHeight;
+      L.cursorX = 0;
+      L.lineStart = j + 1;
+    }
+    L.pos = (j < n) ? j + 1 : j;
+  }
+
+  if (L.pos >= n) {
+    if (L.lineStart < n || L.lines.empty()) {
+      L.lines.push_back({L.lineStart, (uint16_t)(n - min(L.lineStart, n)), L.y});
+    }
+    L.done = true;
+  }
+
+  L.layoutMicros += micros() - t0;
+#ifdef TEXT_LAYOUT_TRACE
+  if (L.done && n > TEXT_LAYOUT_BUDGET) {
+    Serial.printf("[layout] %u bytes -> %u lines in %lu us\n",
+                  (unsigned)n, (unsigned)L.lines.size(), (unsigned long)L.layoutMicros);
+  }
+#endif
+}
+
+// Draw the layout starting at (x, originY) through the glyph atlas at the
+// layout's text size, touching only rows in [minY, maxY).
+void textLayoutDraw(const TextLayout& L, const String& text, int16_t x, int32_t originY, int16_t minY, int16_t maxY,
+                    uint16_t color) {
+  minY = constrain(minY, 0, SCREEN_HEIGHT);
+  maxY = constrain(maxY, 0, SCREEN_HEIGHT);
+  if (minY >= maxY) return;
+
+  // Lines are sorted by y: binary search the first one reaching minY
+  int32_t glyphH = GLYPH_ROWS * L.textSize;
+  size_t lo = 0, hi = L.lines.size();
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (originY + L.lines[mid].y + glyphH <= minY) lo = mid + 1;
+    else hi = mid;
+  }
+
+  const char* s = text.c_str();
+  for (size_t i = lo; i < L.lines.size(); i++) {
+    const TextLine& line = L.lines[i];
+    int32_t y = originY + line.y;
+    if (y >= maxY) break;
+    drawTextRun(x, y, s + line.offset, line.len, L.textSize, color, minY, maxY);
+  }
+}
+
+// y of the last laid-out line, relative to the first
+int32_t textLayoutLastY(const TextLayout& L) {
+  return L.lines.empty() ? 0 : L.lines.back().y;
+}
+
 #include <RDSParser.h>
 
 // ============ RADIO RDA5807M ============
@@ -393,67 +2012,469 @@ struct SystemConfig {
   int breakoutBest;
 };
 
-SystemConfig sysConfig = {"", "", "ESP32", true, 80.0f, 80.0f, 80.0f, false, 255, false, "1234", 15, 1, 0, 0, 0, 0, 0, 10110, 8, 0, 0};
+SystemConfig sysConfig = {"", "", "ESP32", true, 80.0f, 80.0f, 80.0f, false, 255, false, "1234", 15, 1, 0, 0, 0, 0, 0, 10110, 8, 0, 0};
+
+// ============ GLOBAL VARIABLES ============
+int screenBrightness = 255;
+float currentBrightness = 255.0;
+float targetBrightness = 255.0;
+int cursorX = 0, cursorY = 0;
+String userInput = "";
+String passwordInput = "";
+String geminiApiKey = "";
+String binderbyteApiKey = "";
+String selectedSSID = "";
+String aiResponse = "";
+int scrollOffset = 0;
+int menuSelection = 0;
+bool emergencyActive = false;
+unsigned long emergencyEnd = 0;
+
+// ============ UI ANIMATION PHYSICS ============
+bool screenIsDirty = true; // Flag to request a screen redraw
+
+// Invalidation sources collected by the frame scheduler (see FRAME SCHEDULER)
+#define INVAL_INPUT 0x01  // button handled
+#define INVAL_TIMER 0x02  // periodic tick of the current state
+#define INVAL_DATA  0x04  // screenIsDirty or a watched value changed
+#define INVAL_ANIM  0x08  // an animation needs the next frame
+uint8_t pendingInvalidation = INVAL_DATA;
+
+void invalidateScreen(uint8_t source) {
+  pendingInvalidation |= source;
+}
+const int maxBootLines = 16;
+String bootStatusLines[maxBootLines];
+int bootStatusCount = 0;
+int bootProgress = 0;
+unsigned long lastBootAction = 0;
+float eqTextScroll = 0.0f;
+
+// ============ ANIMATION ENGINE ============
+// Springs, eases and tweens share one small pool. Each animation belongs to a
+// state: animationsUpdate() steps only the current state's animations that are
+// still moving, and the frame scheduler asks animationsActive() whether motion
+// is pending, so a screen stops redrawing as soon as it settles. Screens set a
+// target from their cursor when they draw and read the value back.
+#define ANIM_POOL_SIZE 8
+
+enum AnimKind : uint8_t { ANIM_FREE, ANIM_SPRING, ANIM_EASE, ANIM_TWEEN };
+
+struct Anim {
+  AnimKind kind;
+  AppState owner;
+  bool moving;
+  float value, target, velocity;
+  float stiffness, damping; // Spring; ease uses stiffness as its rate per second
+  float epsilon;            // Settle threshold for springs and eases
+  float from, duration, elapsed; // Tween
+};
+
+typedef int8_t AnimHandle; // -1 when the pool is full; every call accepts it
+
+Anim animPool[ANIM_POOL_SIZE];
+
+AnimHandle animAlloc(AnimKind kind, AppState owner) {
+  for (int i = 0; i < ANIM_POOL_SIZE; i++) {
+    if (animPool[i].kind != ANIM_FREE) continue;
+    animPool[i] = Anim();
+    animPool[i].kind = kind;
+    animPool[i].owner = owner;
+    return i;
+  }
+  return -1;
+}
+
+// Damped spring toward the target; velocity is applied scaled by dt * 50
+AnimHandle animCreateSpring(AppState owner, float stiffness, float damping, float epsilon) {
+  AnimHandle h = animAlloc(ANIM_SPRING, owner);
+  if (h >= 0) {
+    animPool[h].stiffness = stiffness;
+    animPool[h].damping = damping;
+    animPool[h].epsilon = epsilon;
+  }
+  return h;
+}
+
+// Exponential approach: closes `rate` of the gap per second
+AnimHandle animCreateEase(AppState owner, float rate, float epsilon) {
+  AnimHandle h = animAlloc(ANIM_EASE, owner);
+  if (h >= 0) {
+    animPool[h].stiffness = rate;
+    animPool[h].epsilon = epsilon;
+  }
+  return h;
+}
+
+// Linear run from the current value to the target over `duration` seconds
+AnimHandle animCreateTween(AppState owner, float duration) {
+  AnimHandle h = animAlloc(ANIM_TWEEN, owner);
+  if (h >= 0) animPool[h].duration = duration;
+  return h;
+}
+
+float animValue(AnimHandle h) {
+  return h >= 0 ? animPool[h].value : 0.0f;
+}
+
+bool animMoving(AnimHandle h) {
+  return h >= 0 && animPool[h].moving;
+}
+
+void animSetTarget(AnimHandle h, float target) {
+  if (h < 0) return;
+  Anim& a = animPool[h];
+  if (target == a.target && (a.moving || a.value == target)) return;
+  a.target = target;
+  a.from = a.value;
+  a.elapsed = 0.0f;
+  a.moving = true;
+}
+
+// Shared animations (one list used by many menus) follow whoever draws them
+void animSetOwner(AnimHandle h, AppState owner) {
+  if (h >= 0) animPool[h].owner = owner;
+}
+
+// Jump to a value and stop
+void animSnap(AnimHandle h, float value) {
+  if (h < 0) return;
+  Anim& a = animPool[h];
+  a.value = a.target = a.from = value;
+  a.velocity = 0.0f;
+  a.moving = false;
+}
+
+void animStep(Anim& a, float dt) {
+  float diff = a.target - a.value;
+  switch (a.kind) {
+    case ANIM_SPRING:
+      a.velocity += diff * a.stiffness;
+      a.velocity *= a.damping;
+      if (fabsf(diff) < a.epsilon && fabsf(a.velocity) < a.epsilon) {
+        a.value = a.target;
+        a.velocity = 0.0f;
+        a.moving = false;
+      } else {
+        a.value += a.velocity * dt * 50.0f;
+      }
+      break;
+    case ANIM_EASE:
+      a.value += diff * min(1.0f, a.stiffness * dt);
+      if (fabsf(a.target - a.value) <= a.epsilon) {
+        a.value = a.target;
+        a.moving = false;
+      }
+      break;
+    case ANIM_TWEEN:
+      a.elapsed += dt;
+      if (a.elapsed >= a.duration) {
+        a.value = a.target;
+        a.moving = false;
+      } else {
+        a.value = a.from + (a.target - a.from) * (a.elapsed / a.duration);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void animationsUpdate(float dt) {
+  for (int i = 0; i < ANIM_POOL_SIZE; i++) {
+    Anim& a = animPool[i];
+    if (a.moving && a.owner == currentState) animStep(a, dt);
+  }
+}
+
+bool animationsActive() {
+  for (int i = 0; i < ANIM_POOL_SIZE; i++) {
+    if (animPool[i].moving && animPool[i].owner == currentState) return true;
+  }
+  return false;
+}
+
+AnimHandle menuScrollAnim = animCreateSpring(STATE_MAIN_MENU, 0.4f, 0.6f, 0.5f);
+AnimHandle prayerSettingsAnim = animCreateSpring(STATE_PRAYER_SETTINGS, 0.3f, 0.7f, 0.1f);
+AnimHandle citySelectAnim = animCreateSpring(STATE_PRAYER_CITY_SELECT, 0.3f, 0.7f, 0.1f);
+AnimHandle eqSettingsAnim = animCreateSpring(STATE_EARTHQUAKE_SETTINGS, 0.3f, 0.7f, 0.1f);
+AnimHandle genericMenuAnim = animCreateEase(STATE_MAIN_MENU, 10.0f, 0.5f);
+AnimHandle chatSlideAnim = animCreateTween(STATE_ESPNOW_CHAT, 0.5f);
+volatile bool chatSlidePending = false; // Set from the ESP-NOW callback, started in loop()
+
+// ============ BUTTON EVENTS ============
+// A 1 ms esp_timer samples the buttons off the UI loop, debounces them and
+// turns edges into press/release/long/repeat events on a lock-free ring with
+// the timer as the only writer of the head and loop() the only writer of the
+// tail. loop() drains the ring once per pass with pollButtonEvents(); handlers
+// then test that pass's events (buttonHit, buttonShort, buttonLong,
+// buttonCombo) or the debounced level (buttonHeld) instead of reading pins.
+// Every press records edge-to-drain time in the "input" profiler probe.
+#define GAME_BTN_UP     0x01
+#define GAME_BTN_DOWN   0x02
+#define GAME_BTN_LEFT   0x04
+#define GAME_BTN_RIGHT  0x08
+#define GAME_BTN_SELECT 0x10
+#define GAME_BTN_BACK   0x20
+
+#define BTN_COUNT 6
+#define BTN_SAMPLE_US 1000
+#define BTN_DEBOUNCE_SAMPLES 5   // Raw level must differ this many samples in a row to flip
+#define BTN_LONG_MS 700
+#define BTN_REPEAT_DELAY_MS 400
+#define BTN_REPEAT_MS 150
+#define BTN_QUEUE_SIZE 32        // Power of two
+
+enum ButtonEventType : uint8_t { BTN_EV_PRESS, BTN_EV_RELEASE, BTN_EV_LONG, BTN_EV_REPEAT };
+
+struct ButtonEvent {
+  uint8_t type;       // ButtonEventType
+  uint8_t button;     // GAME_BTN_* bit
+  bool afterLong;     // RELEASE: a LONG already fired for this press
+  uint32_t us;        // First raw sample of the edge, or when the long/repeat threshold passed
+};
+
+struct ButtonTracker {
+  uint8_t pending;    // Samples the raw level has disagreed with the debounced one
+  bool longFired;
+  uint32_t edgeUs;
+  uint32_t downUs;
+  uint32_t nextRepeatUs;
+};
+
+// Same order as the GAME_BTN_* bits
+const uint8_t btnPins[BTN_COUNT] = {BTN_UP, BTN_DOWN, BTN_LEFT, BTN_RIGHT, BTN_SELECT, BTN_BACK};
+
+ButtonTracker btnTrackers[BTN_COUNT];
+volatile uint8_t btnDebounced = 0;  // GAME_BTN_* held, written by the timer
+ButtonEvent btnQueue[BTN_QUEUE_SIZE];
+uint8_t btnQueueHead = 0;           // Timer only
+uint8_t btnQueueTail = 0;           // loop() only
+esp_timer_handle_t btnTimer = nullptr;
+
+// Events of the current loop pass, filled by pollButtonEvents()
+uint8_t btnPressed = 0;  // PRESS
+uint8_t btnHits = 0;     // PRESS or REPEAT
+uint8_t btnLongs = 0;    // LONG
+uint8_t btnShorts = 0;   // RELEASE before the LONG fired
+uint8_t btnStale = 0;    // Held across a state change; the rest of that press belongs to the old state
+
+uint8_t gameButtonBit(uint8_t pin) {
+  switch (pin) {
+    case BTN_UP:     return GAME_BTN_UP;
+    case BTN_DOWN:   return GAME_BTN_DOWN;
+    case BTN_LEFT:   return GAME_BTN_LEFT;
+    case BTN_RIGHT:  return GAME_BTN_RIGHT;
+    case BTN_SELECT: return GAME_BTN_SELECT;
+    case BTN_BACK:   return GAME_BTN_BACK;
+  }
+  return 0;
+}
+
+void buttonEventPush(uint8_t type, uint8_t button, bool afterLong, uint32_t us) {
+  uint8_t head = btnQueueHead;
+  uint8_t next = (head + 1) & (BTN_QUEUE_SIZE - 1);
+  if (next == __atomic_load_n(&btnQueueTail, __ATOMIC_ACQUIRE)) return; // Full: loop() has stalled, drop it
+  btnQueue[head].type = type;
+  btnQueue[head].button = button;
+  btnQueue[head].afterLong = afterLong;
+  btnQueue[head].us = us;
+  __atomic_store_n(&btnQueueHead, next, __ATOMIC_RELEASE);
+}
+
+// esp_timer task, every BTN_SAMPLE_US
+void buttonSampleTimer(void*) {
+  uint32_t now = micros();
+  uint8_t held = btnDebounced;
+  for (int i = 0; i < BTN_COUNT; i++) {
+    ButtonTracker& t = btnTrackers[i];
+    uint8_t bit = 1 << i;
+    bool raw = digitalRead(btnPins[i]) == BTN_ACT;
+    bool down = held & bit;
+
+    if (raw != down) {
+      if (t.pending == 0) t.edgeUs = now;
+      if (++t.pending < BTN_DEBOUNCE_SAMPLES) continue;
+      t.pending = 0;
+      held ^= bit;
+      if (raw) {
+        t.downUs = t.edgeUs;
+        t.nextRepeatUs = t.edgeUs + BTN_REPEAT_DELAY_MS * 1000UL;
+        t.longFired = false;
+        buttonEventPush(BTN_EV_PRESS, bit, false, t.edgeUs);
+      } else {
+        buttonEventPush(BTN_EV_RELEASE, bit, t.longFired, t.edgeUs);
+      }
+      continue;
+    }
+
+    t.pending = 0;
+    if (!down) continue;
+    if (!t.longFired && now - t.downUs >= BTN_LONG_MS * 1000UL) {
+      t.longFired = true;
+      buttonEventPush(BTN_EV_LONG, bit, false, now);
+    }
+    if ((int32_t)(now - t.nextRepeatUs) >= 0) {
+      t.nextRepeatUs += BTN_REPEAT_MS * 1000UL;
+      buttonEventPush(BTN_EV_REPEAT, bit, false, now);
+    }
+  }
+  btnDebounced = held;
+}
+
+void initButtonEvents() {
+  esp_timer_create_args_t args = {};
+  args.callback = buttonSampleTimer;
+  args.name = "buttons";
+  if (esp_timer_create(&args, &btnTimer) != 0 || esp_timer_start_periodic(btnTimer, BTN_SAMPLE_US) != 0) {
+    Serial.println("[input] Button timer failed to start");
+  }
+}
+
+bool buttonEventPop(ButtonEvent& ev) {
+  uint8_t tail = btnQueueTail;
+  if (tail == __atomic_load_n(&btnQueueHead, __ATOMIC_ACQUIRE)) return false;
+  ev = btnQueue[tail];
+  __atomic_store_n(&btnQueueTail, (uint8_t)((tail + 1) & (BTN_QUEUE_SIZE - 1)), __ATOMIC_RELEASE);
+  return true;
+}
+
+// Once per loop pass; returns true if any event arrived
+bool pollButtonEvents() {
+  btnPressed = btnHits = btnLongs = btnShorts = 0;
+  bool any = false;
+  ButtonEvent ev;
+  while (buttonEventPop(ev)) {
+    any = true;
+    if (ev.type == BTN_EV_PRESS) {
+      btnStale &= ~ev.button;
+      btnPressed |= ev.button;
+      btnHits |= ev.button;
+      profRecord(PROF_INPUT, micros() - ev.us);
+      continue;
+    }
+    if (btnStale & ev.button) {
+      if (ev.type == BTN_EV_RELEASE) btnStale &= ~ev.button;
+      continue;
+    }
+    switch (ev.type) {
+      case BTN_EV_REPEAT:  btnHits |= ev.button; break;
+      case BTN_EV_LONG:    btnLongs |= ev.button; break;
+      case BTN_EV_RELEASE: if (!ev.afterLong) btnShorts |= ev.button; break;
+    }
+  }
+  return any;
+}
+
+// Called on a state change so a press that opened a screen doesn't also
+// repeat, long-press or release-click inside it
+void buttonsIgnoreHeld() {
+  btnStale = btnDebounced;
+}
 
-// ============ GLOBAL VARIABLES ============
-int screenBrightness = 255;
-float currentBrightness = 255.0;
-float targetBrightness = 255.0;
-int cursorX = 0, cursorY = 0;
-String userInput = "";
-String passwordInput = "";
-String geminiApiKey = "";
-String binderbyteApiKey = "";
-String selectedSSID = "";
-String aiResponse = "";
-int scrollOffset = 0;
-int menuSelection = 0;
-unsigned long lastDebounce = 0;
-const unsigned long debounceDelay = 150;
-bool emergencyActive = false;
-unsigned long emergencyEnd = 0;
+// Debounced level, live
+bool buttonHeld(uint8_t pin) {
+  return btnDebounced & gameButtonBit(pin);
+}
 
-// ============ UI ANIMATION PHYSICS ============
-bool screenIsDirty = true; // Flag to request a screen redraw
-const int maxBootLines = 16;
-String bootStatusLines[maxBootLines];
-int bootStatusCount = 0;
-int bootProgress = 0;
-unsigned long lastBootAction = 0;
-float menuScrollCurrent = 0.0f;
-float menuScrollTarget = 0.0f;
-float menuVelocity = 0.0f;
+// Went down or auto-repeated this pass
+bool buttonHit(uint8_t pin) {
+  return btnHits & gameButtonBit(pin);
+}
 
-float prayerSettingsScroll = 0.0f;
-float prayerSettingsVelocity = 0.0f;
-float eqTextScroll = 0.0f;
-float eqSettingsScroll = 0.0f;
-float eqSettingsVelocity = 0.0f;
-float citySelectScroll = 0.0f;
-float citySelectVelocity = 0.0f;
+// Held past BTN_LONG_MS, once per press
+bool buttonLong(uint8_t pin) {
+  return btnLongs & gameButtonBit(pin);
+}
 
-float genericMenuScrollCurrent = 0.0f;
-float genericMenuVelocity = 0.0f;
+// Released before the long press fired
+bool buttonShort(uint8_t pin) {
+  return btnShorts & gameButtonBit(pin);
+}
 
-struct Particle {
-  float x, y, speed;
-  uint8_t size;
-};
-#define NUM_PARTICLES 30
-Particle particles[NUM_PARTICLES];
-bool particlesInit = false;
+// Both held, one of them went down this pass
+bool buttonCombo(uint8_t a, uint8_t b) {
+  uint8_t bits = gameButtonBit(a) | gameButtonBit(b);
+  return (btnDebounced & bits) == bits && (btnPressed & bits);
+}
 
+// ============ FIXED TIMESTEP ============
+// Games advance in fixed SIM_DT steps drawn from an accumulator of real time,
+// so their physics is the same at any frame rate. Step functions copy the
+// state they move into a `...Prev` snapshot first; draw code blends the two
+// with simLerp by simAlpha, the fraction of a step left in the accumulator.
+// Buttons are sampled once per step and read through gameButton(), so a step
+// sees the same input whether it is live or replayed.
+#define SIM_STEP_US 16667UL // 60 Hz
+#define SIM_DT (SIM_STEP_US / 1000000.0f)
+#define SIM_MAX_STEPS 6     // Catch-up per loop; past this the game slows down instead of spiralling
 
-// Rising Smoke Visualizer Particles
-struct SmokeParticle {
-  float x, y;
-  float vx, vy;
-  int life;
-  int maxLife;
-  uint8_t size;
+struct SimClock {
+  uint32_t lastUs;
+  uint32_t accumulatorUs;
+  uint32_t ticks;           // Steps since the last reset
+  bool started;
 };
+
+SimClock simClock = {0, 0, 0, false};
+float simAlpha = 1.0f;
+
+uint8_t simInput = 0xFF;     // GAME_BTN_* held during the current step
+uint8_t simInputPrev = 0xFF; // ...and the step before; all held after a reset, so nothing reads as a fresh press
+uint8_t gameInputSample();   // INPUT REPLAY: live, recorded or replayed buttons
+
+void simReset() {
+  simClock = {0, 0, 0, false};
+  simAlpha = 1.0f;
+  simInput = simInputPrev = 0xFF;
+}
+
+uint8_t readGameButtons() {
+  return btnDebounced;
+}
+
+// Held during this step
+bool gameButton(uint8_t pin) {
+  return simInput & gameButtonBit(pin);
+}
+
+// Went down on this step
+bool gameButtonPressed(uint8_t pin) {
+  uint8_t bit = gameButtonBit(pin);
+  return (simInput & bit) && !(simInputPrev & bit);
+}
+
+// Runs every step that has accumulated by nowUs; returns how many ran
+int simRun(void (*step)(), uint32_t nowUs) {
+  if (!simClock.started) {
+    simClock.started = true;
+    simClock.lastUs = nowUs;
+    simClock.accumulatorUs = SIM_STEP_US; // First step right away
+  }
+  simClock.accumulatorUs += nowUs - simClock.lastUs;
+  simClock.lastUs = nowUs;
+
+  int steps = 0;
+  while (simClock.accumulatorUs >= SIM_STEP_US && steps < SIM_MAX_STEPS) {
+    simInputPrev = simInput;
+    simInput = gameInputSample();
+    step();
+    simClock.accumulatorUs -= SIM_STEP_US;
+    simClock.ticks++;
+    steps++;
+  }
+  if (simClock.accumulatorUs >= SIM_STEP_US) simClock.accumulatorUs %= SIM_STEP_US; // Drop the backlog
+  simAlpha = (float)simClock.accumulatorUs / SIM_STEP_US;
+  return steps;
+}
+
+inline float simLerp(float prev, float cur) {
+  return prev + (cur - prev) * simAlpha;
+}
+
+// Rising Smoke Visualizer Particles: gray 120 fading to gray 20
 #define NUM_SMOKE_PARTICLES 80
-SmokeParticle smokeParticles[NUM_SMOKE_PARTICLES];
+ParticlePool smokeParticles = makeParticlePool(NUM_SMOKE_PARTICLES, PARTICLE_DISC, 0, true, true, 0x10A2);
 
 
 // ============ VISUALS GLOBALS ============
@@ -493,17 +2514,16 @@ struct PongPaddle {
 };
 
 PongBall pongBall;
+PongBall pongBallPrev;
+float player1PrevY = 0;
+float player2PrevY = 0;
 PongPaddle player1, player2;
 bool pongGameActive = false;
 bool pongRunning = false;
 
 // Pong particles
-struct PongParticle {
-  float x, y, vx, vy;
-  int life;
-};
 #define MAX_PONG_PARTICLES 20
-PongParticle pongParticles[MAX_PONG_PARTICLES];
+ParticlePool pongParticles = makeParticlePool(MAX_PONG_PARTICLES, PARTICLE_SQUARE, 10);
 
 
 
@@ -522,15 +2542,10 @@ enum SnakeDirection { SNAKE_UP, SNAKE_DOWN, SNAKE_LEFT, SNAKE_RIGHT };
 SnakeDirection snakeDir;
 bool snakeGameOver;
 int snakeScore;
-unsigned long lastSnakeUpdate = 0;
+uint32_t snakeMoveUs = 0; // Simulated time since the last move
 
-struct SnakeParticle {
-  float x, y, vx, vy;
-  int life;
-  uint16_t color;
-};
 #define MAX_SNAKE_PARTICLES 15
-SnakeParticle snakeParticles[MAX_SNAKE_PARTICLES];
+ParticlePool snakeParticles = makeParticlePool(MAX_SNAKE_PARTICLES, PARTICLE_SQUARE);
 
 // ============ GAME: RACING V3 ============
 #define RACE_MODE_SINGLE 0
@@ -570,24 +2585,35 @@ struct SceneryObject {
 
 Car playerCar = {0, 0, 0, 0, 0, 0};
 Car aiCar = {0.5, 0, 10, 0, 0, 0};
+Car aiCarPrev = aiCar;
 Car opponentCar = {0, 0, 0, 0, 0, 0};
+Car opponentCarPrev = opponentCar;
 bool opponentPresent = false;
-unsigned long lastOpponentUpdate = 0;
 
 Camera camera = {0, 1500, -5000};
+Camera cameraPrev = camera;
 float screenShake = 0;
 
 bool racingGameActive = false;
-#define MAX_ROAD_SEGMENTS 200
+#define RACE_TRACK_SEGMENTS 40 // Segments generated per track
+#define MAX_ROAD_SEGMENTS (RACE_TRACK_SEGMENTS + 8)
 #define SEGMENT_STEP_LENGTH 100
 RoadSegment track[MAX_ROAD_SEGMENTS];
 int totalSegments = 0;
 
-#define MAX_SCENERY 100
+// Compiled by generateTrack: start Z of each segment and the curvature offset
+// accumulated before it (curvature * length). Entry totalSegments holds the
+// lap length and the total offset.
+int32_t trackStartZ[MAX_ROAD_SEGMENTS + 1];
+float trackStartX[MAX_ROAD_SEGMENTS + 1];
+
+#define MAX_SCENERY MAX_ROAD_SEGMENTS // At most one object per segment
 SceneryObject scenery[MAX_SCENERY];
 int sceneryCount = 0;
+// Scenery sorted by z and bucketed by segment: segment s owns
+// scenery[sceneryFirst[s] .. sceneryFirst[s + 1])
+uint16_t sceneryFirst[MAX_ROAD_SEGMENTS + 1];
 
-unsigned long lastRaceUpdate = 0;
 
 // ESP-NOW Racing Packet
 struct RacePacket {
@@ -596,8 +2622,6 @@ struct RacePacket {
   float z;
   float speed;
 };
-RacePacket outgoingRacePacket;
-RacePacket incomingRacePacket;
 
 // ============ TRIVIA QUIZ GAME ============
 #define MAX_QUESTIONS 50
@@ -791,23 +2815,18 @@ struct JumperPlatform {
   float speed; // For moving platforms
 };
 
-struct JumperParticle {
-  float x, y;
-  float vx, vy;
-  int life;
-  uint16_t color;
-};
-
 #define JUMPER_MAX_PLATFORMS 15
 #define JUMPER_MAX_PARTICLES 40
 
 JumperPlayer jumperPlayer;
 JumperPlatform jumperPlatforms[JUMPER_MAX_PLATFORMS];
-JumperParticle jumperParticles[JUMPER_MAX_PARTICLES];
+ParticlePool jumperParticles = makeParticlePool(JUMPER_MAX_PARTICLES, PARTICLE_DISC, 15);
 
 bool jumperGameActive = false;
 int jumperScore = 0;
 float jumperCameraY = 0;
+JumperPlayer jumperPlayerPrev;
+float jumperCameraYPrev = 0;
 const float JUMPER_GRAVITY = 0.45f;
 const float JUMPER_LIFT = -11.0f;
 
@@ -857,7 +2876,9 @@ struct FlappyPipe {
 
 #define FLAPPY_MAX_PIPES 4
 FlappyBird flappyBird;
+float flappyBirdPrevY = 0;
 FlappyPipe flappyPipes[FLAPPY_MAX_PIPES];
+float flappyPipePrevX[FLAPPY_MAX_PIPES];
 bool flappyGameActive = false;
 
 // ============ GAME: BREAKOUT ============
@@ -882,6 +2903,8 @@ struct BreakoutBrick {
 
 BreakoutBall breakoutBall;
 BreakoutPaddle breakoutPaddle;
+BreakoutBall breakoutBallPrev;
+float breakoutPaddlePrevX = 0;
 BreakoutBrick breakoutBricks[BREAKOUT_ROWS][BREAKOUT_COLS];
 bool breakoutGameActive = false;
 int breakoutScore = 0;
@@ -1336,18 +3359,285 @@ bool espnowBroadcastMode = true; // true = broadcast, false = unicast to selecte
 String myNickname = "ESP32";
 
 typedef struct __attribute__((packed)) struct_message {
-  char type; // 'M' = message, 'H' = hello/handshake, 'P' = ping, 'R' = race data
+  char type; // 'M' = message, 'H' = hello/handshake, 'P' = ping ('S' race sync is a RaceSyncPacket)
   char nickname[32];
   unsigned long timestamp;
   union {
     char text[ESPNOW_MESSAGE_MAX_LEN];
-    RacePacket raceData;
   };
 } struct_message;
 
 struct_message outgoingMsg;
 struct_message incomingMsg;
 
+// ============ RACE SYNC ============
+// Multiplayer racing state exchange. Each side broadcasts fixed-rate
+// snapshots with a sequence number and its own clock, and echoes the newest
+// timestamp it heard. The echo gives the round trip and, NTP style, the
+// offset between the two clocks, so snapshots can be placed on the local
+// timeline. The opponent is drawn RACE_SYNC_INTERP_MS in the past,
+// interpolated between the snapshots around that moment, and dead-reckoned
+// for a short while when packets stop arriving. Every packet also carries
+// the seed the sender built its track from; both sides settle on the lower
+// one and rebuild from it, so z means the same road on each end.
+#define RACE_SYNC_INTERVAL_MS 50     // 20 Hz snapshots
+#define RACE_SYNC_INTERP_MS 120      // Two intervals plus jitter
+#define RACE_SYNC_EXTRAPOLATE_MS 250 // Longest dead reckoning past the newest snapshot
+#define RACE_SYNC_TIMEOUT_MS 2000    // Opponent dropped after this much silence
+#define RACE_SYNC_SNAPSHOTS 8
+#define RACE_SYNC_NO_ECHO 0xFFFF     // holdMs value when nothing has been heard yet
+#define RACE_Z_PER_SPEED 5.0f        // Track z per second per unit of speed
+
+struct __attribute__((packed)) RaceSyncPacket {
+  char type;       // 'S', in the same place as struct_message.type
+  uint16_t seq;
+  uint32_t sentMs; // Sender clock when sent
+  uint32_t echoMs; // sentMs of the newest packet the sender has received
+  uint16_t holdMs; // How long the sender held it before this send
+  uint32_t trackSeed;
+  RacePacket car;
+};
+
+struct RaceSnapshot {
+  uint32_t remoteMs;
+  RacePacket car;
+};
+
+struct RaceSync {
+  uint16_t nextSeq;
+  uint32_t lastSendMs;
+  bool haveRemote;
+  uint16_t lastSeq;
+  uint32_t lastRemoteMs;  // sentMs of the newest packet
+  uint32_t lastRecvMs;    // Local time it arrived
+  bool synced;            // offsetMs comes from a measured round trip
+  float offsetMs;         // Remote clock minus local clock
+  float rttMs;
+  RaceSnapshot snaps[RACE_SYNC_SNAPSHOTS];
+  uint8_t snapHead;
+  uint8_t snapCount;
+  uint32_t trackSeed;       // rngTrack seed of our track
+  uint32_t remoteTrackSeed; // Seed of the peer's track, once heard
+  uint32_t received, lost, stale, restarts;
+};
+
+RaceSync raceSync;
+portMUX_TYPE raceSyncMux = portMUX_INITIALIZER_UNLOCKED; // Receive runs in the WiFi task
+
+void raceSyncReset(RaceSync& s) {
+  memset(&s, 0, sizeof(s));
+}
+
+// Fills `out` when the next snapshot is due
+bool raceSyncPrepare(RaceSync& s, uint32_t nowMs, const RacePacket& car, RaceSyncPacket& out) {
+  if (s.nextSeq != 0 && nowMs - s.lastSendMs < RACE_SYNC_INTERVAL_MS) return false;
+  s.lastSendMs = nowMs;
+  out.type = 'S';
+  out.seq = s.nextSeq++;
+  out.sentMs = nowMs;
+  out.echoMs = s.lastRemoteMs;
+  uint32_t hold = nowMs - s.lastRecvMs;
+  out.holdMs = !s.haveRemote ? RACE_SYNC_NO_ECHO : (hold < RACE_SYNC_NO_ECHO ? hold : RACE_SYNC_NO_ECHO - 1);
+  out.trackSeed = s.trackSeed;
+  out.car = car;
+  return true;
+}
+
+void raceSyncReceive(RaceSync& s, const RaceSyncPacket& p, uint32_t nowMs) {
+  if (s.haveRemote) {
+    int16_t ahead = (int16_t)(p.seq - s.lastSeq);
+    int32_t newer = (int32_t)(p.sentMs - s.lastRemoteMs);
+    // The peer re-entered the race (seq back to 0 while its clock moved on),
+    // rebooted (clock went back) or went quiet: start over as a new stream
+    if (nowMs - s.lastRecvMs > RACE_SYNC_TIMEOUT_MS || (ahead <= 0 && newer > 0) ||
+        newer < -(int32_t)RACE_SYNC_TIMEOUT_MS) {
+      s.haveRemote = false;
+      s.synced = false;
+      s.snapHead = 0;
+      s.snapCount = 0;
+      s.restarts++;
+    } else if (ahead <= 0 || newer <= 0) {
+      s.stale++; // Duplicate, or overtaken by a newer snapshot
+      return;
+    } else {
+      s.lost += ahead - 1;
+    }
+  }
+  s.received++;
+  s.haveRemote = true;
+  s.lastSeq = p.seq;
+  s.lastRemoteMs = p.sentMs;
+  s.lastRecvMs = nowMs;
+  s.remoteTrackSeed = p.trackSeed;
+
+  // Our echoed send left at echoMs and this packet arrives now; the peer held
+  // it for holdMs in between. Half the remaining time is the one-way delay.
+  int32_t rtt = p.holdMs == RACE_SYNC_NO_ECHO ? -1 : (int32_t)(nowMs - p.echoMs) - p.holdMs;
+  if (rtt >= 0) {
+    float offset = (int32_t)(p.sentMs - nowMs) + rtt / 2.0f;
+    if (!s.synced) {
+      s.offsetMs = offset;
+      s.rttMs = rtt;
+      s.synced = true;
+    } else if (rtt <= s.rttMs * 2 + 4) { // Skip samples inflated by queueing
+      s.offsetMs += (offset - s.offsetMs) / 8;
+      s.rttMs += (rtt - s.rttMs) / 8;
+    }
+  } else if (!s.synced) {
+    s.offsetMs = (int32_t)(p.sentMs - nowMs); // Best guess until a round trip completes
+  }
+
+  s.snaps[s.snapHead] = {p.sentMs, p.car};
+  s.snapHead = (s.snapHead + 1) % RACE_SYNC_SNAPSHOTS;
+  if (s.snapCount < RACE_SYNC_SNAPSHOTS) s.snapCount++;
+}
+
+// True when the peer's track wins and ours must be rebuilt from s.trackSeed
+bool raceSyncAdoptTrack(RaceSync& s) {
+  if (!s.haveRemote || s.remoteTrackSeed >= s.trackSeed) return false;
+  s.trackSeed = s.remoteTrackSeed;
+  return true;
+}
+
+// Opponent state to draw at nowMs; false when nothing recent enough arrived.
+// trackLength lets z interpolate across the lap wrap.
+bool raceSyncSample(const RaceSync& s, uint32_t nowMs, float trackLength, RacePacket& out) {
+  if (s.snapCount == 0 || nowMs - s.lastRecvMs > RACE_SYNC_TIMEOUT_MS) return false;
+  uint32_t t = nowMs + (int32_t)lroundf(s.offsetMs) - RACE_SYNC_INTERP_MS; // On the remote clock
+
+  auto snap = [&](int age) -> const RaceSnapshot& {
+    return s.snaps[(s.snapHead + RACE_SYNC_SNAPSHOTS - 1 - age) % RACE_SYNC_SNAPSHOTS];
+  };
+  auto wrapZ = [&](float z) {
+    if (trackLength > 0) {
+      while (z >= trackLength) z -= trackLength;
+      while (z < 0) z += trackLength;
+    }
+    return z;
+  };
+
+  const RaceSnapshot& newest = snap(0);
+  int32_t ahead = (int32_t)(t - newest.remoteMs);
+  if (ahead >= 0) {
+    if (ahead > RACE_SYNC_EXTRAPOLATE_MS) ahead = RACE_SYNC_EXTRAPOLATE_MS;
+    out = newest.car;
+    out.z = wrapZ(out.z + newest.car.speed * RACE_Z_PER_SPEED * (ahead / 1000.0f));
+    return true;
+  }
+
+  for (int age = 1; age < s.snapCount; age++) {
+    const RaceSnapshot& a = snap(age);
+    if ((int32_t)(t - a.remoteMs) < 0) continue;
+    const RaceSnapshot& b = snap(age - 1);
+    float f = (float)(int32_t)(t - a.remoteMs) / (float)(int32_t)(b.remoteMs - a.remoteMs);
+    float dz = b.car.z - a.car.z;
+    if (trackLength > 0) {
+      if (dz > trackLength / 2) dz -= trackLength;
+      else if (dz < -trackLength / 2) dz += trackLength;
+    }
+    out.x = a.car.x + (b.car.x - a.car.x) * f;
+    out.y = a.car.y + (b.car.y - a.car.y) * f;
+    out.z = wrapZ(a.car.z + dz * f);
+    out.speed = a.car.speed + (b.car.speed - a.car.speed) * f;
+    return true;
+  }
+  out = snap(s.snapCount - 1).car; // Older than the whole buffer
+  return true;
+}
+
+#ifdef RACE_SYNC_LOOPBACK_TEST
+// Build with -DRACE_SYNC_LOOPBACK_TEST to run two RaceSync endpoints over a
+// simulated link with latency, jitter and loss once from setup(). Reports the
+// clock offset estimate and how far the interpolated opponent strays from
+// where it really was. Halfway through A leaves and re-enters the race, so B
+// has to pick up A's restarted sequence, and both must end on one track.
+void runRaceSyncLoopbackTest() {
+  const uint32_t clockB = 123457;  // B's clock runs this far ahead of A's
+  const uint32_t latencyMs = 15;   // One-way base latency
+  const uint32_t jitterMs = 20;    // Uniform extra delay, so packets reorder
+  const uint32_t lossPercent = 10;
+  const float trackLength = 5000;  // Short lap to cross the wrap often
+  const float speed = 60;
+  const uint32_t durationMs = 20000, warmupMs = 1000;
+  const uint32_t restartMs = 10000;
+
+  struct InFlight {
+    uint32_t deliverAt;
+    uint8_t to;
+    RaceSyncPacket packet;
+  };
+  InFlight link[64];
+  int inFlight = 0;
+  RaceSync ends[2];
+  raceSyncReset(ends[0]);
+  raceSyncReset(ends[1]);
+  ends[0].trackSeed = 7;
+  ends[1].trackSeed = 3;
+
+  auto carAt = [&](uint32_t ms) -> RacePacket {
+    float z = fmodf(speed * RACE_Z_PER_SPEED * ms / 1000.0f, trackLength);
+    return {0.8f * sinf(ms / 700.0f), 0, z, speed};
+  };
+
+  float sumZ = 0, maxZ = 0, sumX = 0, maxX = 0;
+  int samples = 0;
+  uint32_t lastSampleMs = 0;
+  for (uint32_t t = 0; t < durationMs; t++) {
+    if (t == restartMs) { // Packets already in flight still arrive
+      raceSyncReset(ends[0]);
+      ends[0].trackSeed = 9;
+    }
+
+    // Deliver due packets
+    for (int i = 0; i < inFlight;) {
+      if (link[i].deliverAt > t) {
+        i++;
+        continue;
+      }
+      uint32_t local = link[i].to == 0 ? t : t + clockB;
+      raceSyncReceive(ends[link[i].to], link[i].packet, local);
+      link[i] = link[--inFlight];
+    }
+
+    // Both sides send; A drives the car being checked, B sits still
+    for (uint8_t from = 0; from < 2; from++) {
+      raceSyncAdoptTrack(ends[from]);
+      uint32_t local = from == 0 ? t : t + clockB;
+      RacePacket car = from == 0 ? carAt(t) : RacePacket{0, 0, 0, 0};
+      RaceSyncPacket packet;
+      if (!raceSyncPrepare(ends[from], local, car, packet)) continue;
+      if (rngBelow(rngParticles, 100) < lossPercent || inFlight == 64) continue;
+      link[inFlight++] = {t + latencyMs + rngBelow(rngParticles, jitterMs + 1), (uint8_t)(1 - from), packet};
+    }
+
+    // B draws A at its frame rate
+    if (t < warmupMs || t % 16 != 0) continue;
+    RacePacket seen;
+    if (!raceSyncSample(ends[1], t + clockB, trackLength, seen)) continue;
+    RacePacket truth = carAt(t - RACE_SYNC_INTERP_MS);
+    float dz = fabsf(seen.z - truth.z);
+    if (dz > trackLength / 2) dz = trackLength - dz;
+    float dx = fabsf(seen.x - truth.x);
+    sumZ += dz;
+    sumX += dx;
+    if (dz > maxZ) maxZ = dz;
+    if (dx > maxX) maxX = dx;
+    samples++;
+    lastSampleMs = t;
+  }
+
+  const RaceSync& b = ends[1];
+  float offsetErr = fabsf(b.offsetMs - (-(float)clockB));
+  bool recovered = b.restarts == 1 && durationMs - lastSampleMs <= 100;
+  bool sameTrack = ends[0].trackSeed == 3 && b.trackSeed == 3;
+  bool pass = samples > 0 && recovered && sameTrack && offsetErr <= 5 && sumZ / samples < 15;
+  Serial.printf("[RACESYNC] offset error %.1f ms, rtt %.1f ms, received %u, lost %u, stale %u, restarts %u, track seeds %u/%u\n",
+                offsetErr, b.rttMs, b.received, b.lost, b.stale, b.restarts, ends[0].trackSeed, b.trackSeed);
+  Serial.printf("[RACESYNC] z error avg %.1f max %.1f, x error avg %.3f max %.3f over %d frames: %s\n",
+                samples ? sumZ / samples : 0, maxZ, samples ? sumX / samples : 0, maxX, samples, pass ? "PASS" : "FAIL");
+}
+#endif
+
 // ============ KEYBOARD LAYOUTS ============
 const char* keyboardLower[3][10] = {
   {"q", "w", "e", "r", "t", "y", "u", "i", "o", "p"},
@@ -1381,7 +3671,6 @@ KeyboardContext keyboardContext = CONTEXT_CHAT;
 
 // ============ CHAT THEME & ANIMATION ============
 int chatTheme = 0; // 0: Modern, 1: Bubble, 2: Cyberpunk
-float chatAnimProgress = 1.0f;
 
 // ============ WIFI SCANNER ============
 struct WiFiNetwork {
@@ -1410,6 +3699,7 @@ int perfLPS = 0;
 bool showFPS = false;
 
 int cachedRSSI = 0;
+bool cachedWifiConnected = false;
 String cachedTimeStr = "";
 unsigned long lastStatusBarUpdate = 0;
 int batteryPercentage = -1; // -1 indicates not yet read
@@ -1420,15 +3710,16 @@ String chatHistory = "";
 
 // Screensaver
 #define SCREENSAVER_TIMEOUT 90000 // 1.5 minutes
-unsigned long lastScreensaverUpdate = 0;
 
+// OUT: outgoing frame captured, incoming not rendered yet. IN: compositing.
 enum TransitionState { TRANSITION_NONE, TRANSITION_OUT, TRANSITION_IN };
+enum TransitionStyle { TRANSITION_SLIDE, TRANSITION_SLIDE_BACK, TRANSITION_FADE, TRANSITION_WIPE };
 TransitionState transitionState = TRANSITION_NONE;
+TransitionStyle transitionStyle = TRANSITION_SLIDE;
 float transitionProgress = 0.0;
 const float transitionSpeed = 3.5f;
 
 unsigned long lastUiUpdate = 0;
-const int uiFrameDelay = 1000 / TARGET_FPS;
 
 // ============ SD CARD ============
 #define SDCARD_CS   3
@@ -1451,7 +3742,6 @@ int totalTracks = 0;
 int currentTrackIdx = 1;
 bool musicIsPlaying = false;
 unsigned long visualizerMillis = 0;
-unsigned long lastVolumeChangeMillis = 0;
 unsigned long lastTrackCheckMillis = 0;
 bool forceMusicStateUpdate = false;
 
@@ -1476,15 +3766,6 @@ struct MusicMetadata {
 };
 std::vector<MusicMetadata> musicPlaylist;
 
-// Long press state variables for music player
-unsigned long btnLeftPressTime = 0;
-unsigned long btnRightPressTime = 0;
-unsigned long btnSelectPressTime = 0;
-bool btnLeftLongPressTriggered = false;
-bool btnRightLongPressTriggered = false;
-bool btnSelectLongPressTriggered = false;
-const unsigned long longPressDuration = 700; // 700ms
-
 // Simulated progress bar variables
 unsigned long trackStartTime = 0;
 unsigned long musicPauseTime = 0;
@@ -1614,12 +3895,6 @@ String pomoQuote = ""; // To store the AI-generated quote
 bool pomoQuoteLoading = false; // To indicate if a quote is being fetched
 
 
-// Long press state variables for pomodoro player
-unsigned long pomoBtnLeftPressTime = 0;
-unsigned long pomoBtnRightPressTime = 0;
-bool pomoBtnLeftLongPressTriggered = false;
-bool pomoBtnRightLongPressTriggered = false;
-
 // ============ CONVERSATION CONTEXT STRUCTURE ============
 
 // ============ AI PERSONALITY & CONTEXT - DUAL MODE ============
@@ -1694,7 +3969,6 @@ void scanWiFiNetworks(bool switchToScanState = true);
 void sendToGemini();
 void triggerNeoPixelEffect(uint32_t color, int duration);
 void updateNeoPixel();
-void updateParticles();
 void ledQuickFlash();
 void ledSuccess();
 void ledError();
@@ -1749,9 +4023,9 @@ String getRecentChatContext(int maxMessages);
 void drawPinLock(bool isChanging);
 void handlePinLockKeyPress();
 void loadApiKeys();
-void updateAndDrawPongParticles();
 void triggerPongParticles(float x, float y);
 void drawSnakeGame();
+void initSnakeGame();
 void updateSnakeLogic();
 void initFlappyGame();
 void updateFlappyLogic();
@@ -1770,7 +4044,7 @@ void drawEQIcon(int x, int y, uint8_t eqMode);
 void drawVerticalVisualizer();
 String formatTime(int seconds);
 void updateBatteryLevel();
-void drawBatteryIcon();
+void drawBatteryIcon(GFXcanvas16& g);
 void drawBootScreen(const char* lines[], int lineCount, int progress);
 float custom_lerp(float a, float b, float f);
 void drawGradientVLine(int16_t x, int16_t y, int16_t h, uint16_t color1, uint16_t color2);
@@ -1868,6 +4142,358 @@ void handleUTTTInput();
 void handleUTTTMenuInput();
 void handleUTTTGameOverInput();
 
+// ============ INPUT REPLAY ============
+// Records a game session as its RNG seed plus the buttons held on every fixed
+// step, and plays it back through gameInputSample() so the same build replays
+// it bit for bit. Gameplay draws only on rngGame/rngTrack and SIM_DT, so the
+// seed and the inputs decide everything; cosmetic streams may differ. Both
+// modes collect frame interval and render time histograms, so two builds can
+// be compared on identical gameplay. Serial: 'c' arms recording for the next
+// game (or restarts the current one) and stops it, 'y' replays REPLAY_PATH.
+#define REPLAY_PATH "/replay.rpl"
+#define REPLAY_VERSION 2
+#define REPLAY_MAX_RUNS 16384 // 48 KB of runs; recording stops when full
+
+enum ReplayMode : uint8_t { REPLAY_OFF, REPLAY_ARMED, REPLAY_RECORDING, REPLAY_CUED, REPLAY_PLAYING };
+
+struct __attribute__((packed)) ReplayHeader {
+  char magic[4];      // "RPLY"
+  uint8_t version;
+  uint8_t state;      // AppState of the game
+  uint32_t simStepUs; // Replays only make sense at the step they were made with
+  uint32_t seed;
+  uint32_t steps;
+  uint32_t runCount;
+  uint32_t endCheck;  // replayFingerprint() after the last step
+};
+
+struct __attribute__((packed)) ReplayRun {
+  uint8_t buttons;
+  uint16_t count;
+};
+
+struct ReplaySession {
+  ReplayMode mode;
+  ReplayHeader header;
+  ReplayRun* runs;
+  uint32_t runCap;
+  uint32_t step;      // Steps recorded or played so far
+  uint32_t run;       // Playback position
+  uint16_t inRun;
+  uint32_t lastFrameUs;
+  ProbeStats interval;
+  ProbeStats render;
+};
+
+ReplaySession replay = {REPLAY_OFF};
+
+void replayStopRecording();
+
+// FNV-1a over 32-bit words
+uint32_t replayMix(uint32_t h, uint32_t v) {
+  return (h ^ v) * 16777619u;
+}
+
+uint32_t replayMixF(uint32_t h, float f) {
+  uint32_t v;
+  memcpy(&v, &f, sizeof(v));
+  return replayMix(h, v);
+}
+
+// Step count, rngGame and the state of the recorded game, so a replay that
+// drifts anywhere in positions or score is caught, not just in RNG draws
+uint32_t replayFingerprint() {
+  uint32_t h = 2166136261u;
+  h = replayMix(h, simClock.ticks);
+  for (int i = 0; i < 4; i++) h = replayMix(h, rngGame.s[i]);
+  switch ((AppState)replay.header.state) {
+    case STATE_GAME_PONG:
+      h = replayMixF(h, pongBall.x);
+      h = replayMixF(h, pongBall.y);
+      h = replayMixF(h, pongBall.vx);
+      h = replayMixF(h, pongBall.vy);
+      h = replayMixF(h, player1.y);
+      h = replayMixF(h, player2.y);
+      h = replayMix(h, player1.score);
+      h = replayMix(h, player2.score);
+      break;
+    case STATE_GAME_RACING:
+      h = replayMixF(h, playerCar.x);
+      h = replayMixF(h, playerCar.z);
+      h = replayMixF(h, playerCar.speed);
+      h = replayMix(h, playerCar.lap);
+      h = replayMixF(h, aiCar.x);
+      h = replayMixF(h, aiCar.z);
+      h = replayMixF(h, aiCar.speed);
+      break;
+    case STATE_GAME_SNAKE:
+      h = replayMix(h, snakeLength);
+      for (int i = 0; i < snakeLength; i++) h = replayMix(h, (snakeBody[i].x << 16) ^ snakeBody[i].y);
+      h = replayMix(h, (food.x << 16) ^ food.y);
+      h = replayMix(h, snakeScore);
+      h = replayMix(h, snakeGameOver);
+      break;
+    case STATE_GAME_PLATFORMER:
+      h = replayMixF(h, jumperPlayer.x);
+      h = replayMixF(h, jumperPlayer.y);
+      h = replayMixF(h, jumperPlayer.vy);
+      h = replayMixF(h, jumperCameraY);
+      h = replayMix(h, jumperScore);
+      break;
+    case STATE_GAME_FLAPPY:
+      h = replayMixF(h, flappyBird.y);
+      h = replayMixF(h, flappyBird.vy);
+      h = replayMix(h, flappyBird.score);
+      for (int i = 0; i < FLAPPY_MAX_PIPES; i++) h = replayMixF(h, flappyPipes[i].x);
+      break;
+    case STATE_GAME_BREAKOUT:
+      h = replayMixF(h, breakoutBall.x);
+      h = replayMixF(h, breakoutBall.y);
+      h = replayMixF(h, breakoutBall.vx);
+      h = replayMixF(h, breakoutBall.vy);
+      h = replayMixF(h, breakoutPaddle.x);
+      h = replayMix(h, breakoutScore);
+      break;
+    default:
+      break;
+  }
+  return h;
+}
+
+// Puts a game back to its opening state from the current seed
+void gameRestart(AppState state) {
+  switch (state) {
+    case STATE_GAME_PONG:
+      pongGameActive = false;
+      break;
+    case STATE_GAME_RACING:
+      raceGameMode = RACE_MODE_SINGLE;
+      racingGameActive = false;
+      break;
+    case STATE_GAME_SNAKE:      initSnakeGame(); break;
+    case STATE_GAME_PLATFORMER: initPlatformerGame(); break;
+    case STATE_GAME_FLAPPY:     initFlappyGame(); break;
+    case STATE_GAME_BREAKOUT:   initBreakoutGame(); break;
+    default: break;
+  }
+}
+
+bool isFixedStepGame(AppState state) {
+  return state == STATE_GAME_PONG || state == STATE_GAME_RACING || state == STATE_GAME_SNAKE ||
+         state == STATE_GAME_PLATFORMER || state == STATE_GAME_FLAPPY || state == STATE_GAME_BREAKOUT;
+}
+
+void replayResetStats() {
+  memset(&replay.interval, 0, sizeof(replay.interval));
+  memset(&replay.render, 0, sizeof(replay.render));
+  replay.interval.minUs = replay.render.minUs = 0xFFFFFFFF;
+  replay.lastFrameUs = 0;
+}
+
+void replayReportStats(const char* what) {
+  auto line = [](const char* name, const ProbeStats& s) {
+    if (s.count == 0) return;
+    Serial.printf("[replay]   %-8s p50 %5lu  p90 %5lu  p99 %5lu  max %6lu us\n", name,
+                  (unsigned long)profPercentile(s, 50), (unsigned long)profPercentile(s, 90),
+                  (unsigned long)profPercentile(s, 99), (unsigned long)s.maxUs);
+  };
+  Serial.printf("[replay] %s: %lu steps, %lu frames\n", what, (unsigned long)replay.step,
+                (unsigned long)replay.render.count);
+  line("interval", replay.interval);
+  line("render", replay.render);
+}
+
+// Called when a fixed-step game starts (state entered or restarted)
+void replayGameStarted(AppState state) {
+  if (replay.mode == REPLAY_ARMED) {
+    if (state == STATE_GAME_RACING && raceGameMode == RACE_MODE_MULTI) {
+      Serial.println(F("[replay] multiplayer races can't be recorded"));
+      replay.mode = REPLAY_OFF;
+      return;
+    }
+    memcpy(replay.header.magic, "RPLY", 4);
+    replay.header.version = REPLAY_VERSION;
+    replay.header.state = state;
+    replay.header.simStepUs = SIM_STEP_US;
+    replay.header.seed = esp_random();
+    replay.header.steps = 0;
+    replay.header.runCount = 0;
+    replay.step = 0;
+    rngSeedAll(replay.header.seed);
+    gameRestart(state);
+    replayResetStats();
+    replay.mode = REPLAY_RECORDING;
+    Serial.printf("[replay] recording, seed %08lx\n", (unsigned long)replay.header.seed);
+  } else if (replay.mode == REPLAY_CUED && state == replay.header.state) {
+    replay.step = 0;
+    replay.run = 0;
+    replay.inRun = 0;
+    rngSeedAll(replay.header.seed);
+    gameRestart(state);
+    replayResetStats();
+    replay.mode = REPLAY_PLAYING;
+    Serial.printf("[replay] playing %lu steps\n", (unsigned long)replay.header.steps);
+  } else if (replay.mode == REPLAY_RECORDING) {
+    replayStopRecording(); // Leaving the game ends the recording
+  } else if (replay.mode == REPLAY_PLAYING) {
+    replay.mode = REPLAY_OFF;
+    Serial.println(F("[replay] playback abandoned"));
+  }
+}
+
+void replayStopRecording() {
+  replay.mode = REPLAY_OFF;
+  replay.header.steps = replay.step;
+  replay.header.endCheck = replayFingerprint();
+  replayReportStats("recorded");
+  if (!sdCardMounted || !beginSD()) {
+    Serial.println(F("[replay] no SD card, recording discarded"));
+    return;
+  }
+  File f = SD.open(REPLAY_PATH, FILE_WRITE);
+  if (f) {
+    f.write((const uint8_t*)&replay.header, sizeof(replay.header));
+    f.write((const uint8_t*)replay.runs, replay.header.runCount * sizeof(ReplayRun));
+    f.close();
+    Serial.printf("[replay] saved %s (%lu runs)\n", REPLAY_PATH, (unsigned long)replay.header.runCount);
+  } else {
+    Serial.println(F("[replay] can't write " REPLAY_PATH));
+  }
+  endSD();
+}
+
+void replayFinishPlayback() {
+  replay.mode = REPLAY_OFF;
+  bool match = replayFingerprint() == replay.header.endCheck;
+  replayReportStats(match ? "replayed, state matches" : "replayed, state DIVERGED");
+}
+
+// 'c': arm recording (or restart the running game into a recording); again to stop
+void replayToggleRecord() {
+  if (replay.mode == REPLAY_RECORDING) {
+    replayStopRecording();
+    return;
+  }
+  replay.mode = REPLAY_ARMED;
+  if (isFixedStepGame(currentState)) {
+    simReset();
+    replayGameStarted(currentState);
+  } else {
+    Serial.println(F("[replay] armed, recording starts with the next game"));
+  }
+}
+
+// 'y': load REPLAY_PATH and play it from the start of its game
+void replayStart() {
+  if (replay.mode == REPLAY_RECORDING) replayStopRecording();
+  if (!sdCardMounted || !beginSD()) {
+    Serial.println(F("[replay] no SD card"));
+    return;
+  }
+  File f = SD.open(REPLAY_PATH, FILE_READ);
+  ReplayHeader h;
+  bool ok = f && f.readBytes((uint8_t*)&h, sizeof(h)) == sizeof(h) && memcmp(h.magic, "RPLY", 4) == 0 &&
+            h.version == REPLAY_VERSION && h.simStepUs == SIM_STEP_US && h.runCount <= REPLAY_MAX_RUNS &&
+            isFixedStepGame((AppState)h.state);
+  if (ok && h.runCount > replay.runCap) {
+    ReplayRun* runs = (ReplayRun*)realloc(replay.runs, h.runCount * sizeof(ReplayRun));
+    if (runs) {
+      replay.runs = runs;
+      replay.runCap = h.runCount;
+    }
+    ok = runs != nullptr;
+  }
+  ok = ok && f.readBytes((uint8_t*)replay.runs, h.runCount * sizeof(ReplayRun)) == h.runCount * sizeof(ReplayRun);
+  if (ok) {
+    // Runs must cover exactly the recorded steps, or playback would read past them
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < h.runCount; i++) total += replay.runs[i].count;
+    ok = total == h.steps;
+  }
+  if (f) f.close();
+  endSD();
+  if (!ok) {
+    Serial.println(F("[replay] no usable " REPLAY_PATH));
+    return;
+  }
+
+  replay.header = h;
+  replay.mode = REPLAY_CUED;
+  if (currentState == (AppState)h.state) {
+    simReset();
+    replayGameStarted(currentState);
+  } else {
+    changeState((AppState)h.state); // Starts from the loop's state-change hook
+  }
+}
+
+// Serial console, polled every loop: replay commands in every build, the
+// profiler's when it is compiled in
+void handleSerialCommands() {
+  while (Serial.available() > 0) {
+    char c = Serial.read();
+    switch (c) {
+      case 'c': replayToggleRecord(); break;
+      case 'y': replayStart(); break;
+#if FRAME_PROFILER
+      default: handleProfilerCommand(c); break;
+#endif
+    }
+  }
+}
+
+uint8_t gameInputSample() {
+  uint8_t live = readGameButtons();
+  if (replay.mode == REPLAY_RECORDING) {
+    uint32_t n = replay.header.runCount;
+    if (n > 0 && replay.runs[n - 1].buttons == live && replay.runs[n - 1].count < 0xFFFF) {
+      replay.runs[n - 1].count++;
+    } else if (n < REPLAY_MAX_RUNS) {
+      if (n == replay.runCap) {
+        uint32_t cap = replay.runCap ? replay.runCap * 2 : 256;
+        ReplayRun* runs = (ReplayRun*)realloc(replay.runs, cap * sizeof(ReplayRun));
+        if (runs == nullptr) {
+          replayStopRecording();
+          return live;
+        }
+        replay.runs = runs;
+        replay.runCap = cap;
+      }
+      replay.runs[n] = {live, 1};
+      replay.header.runCount = n + 1;
+    } else {
+      replayStopRecording();
+      return live;
+    }
+    replay.step++;
+    return live;
+  }
+
+  if (replay.mode == REPLAY_PLAYING) {
+    if (replay.step >= replay.header.steps || replay.run >= replay.header.runCount) {
+      replayFinishPlayback();
+      return live;
+    }
+    const ReplayRun& r = replay.runs[replay.run];
+    uint8_t buttons = r.buttons;
+    if (++replay.inRun >= r.count) {
+      replay.run++;
+      replay.inRun = 0;
+    }
+    replay.step++;
+    return buttons;
+  }
+  return live;
+}
+
+// Frame timing while a session runs; called from scheduleFrame()
+void replayFrame(uint32_t startUs, uint32_t renderUs) {
+  if (replay.mode != REPLAY_RECORDING && replay.mode != REPLAY_PLAYING) return;
+  if (replay.lastFrameUs != 0) probeRecord(replay.interval, startUs - replay.lastFrameUs);
+  replay.lastFrameUs = startUs;
+  probeRecord(replay.render, renderUs);
+}
+
 // ===== LOCATION DETECTION =====
 void fetchUserLocation() {
   if (WiFi.status() != WL_CONNECTED) {
@@ -1877,6 +4503,7 @@ void fetchUserLocation() {
 
   Serial.println("Fetching location from IP (HTTPS)...");
 
+  CanvasHeapRelief heapRelief;
   WiFiClientSecure client;
   client.setInsecure();
   HTTPClient http;
@@ -1958,6 +4585,7 @@ void fetchPrayerTimes() {
   url += "&method=" + String(prayerSettings.calculationMethod);
   url += "&adjustment=" + String(prayerSettings.hijriAdjustment);
 
+  CanvasHeapRelief heapRelief;
   WiFiClientSecure client;
   client.setInsecure();
   HTTPClient http;
@@ -2188,6 +4816,7 @@ void fetchBMKGData() {
   // We'll use Felt earthquakes for more detailed info
   String url = "https://data.bmkg.go.id/DataMKG/TEWS/gempadirasakan.json";
 
+  CanvasHeapRelief heapRelief;
   WiFiClientSecure client;
   client.setInsecure();
   HTTPClient http;
@@ -2291,6 +4920,7 @@ void fetchEarthquakeData() {
     url += "all_day.geojson";
   }
 
+  CanvasHeapRelief heapRelief;
   WiFiClientSecure client;
   client.setInsecure();
   HTTPClient http;
@@ -2474,6 +5104,7 @@ void fetchQuizQuestions() {
     else if (quizSettings.difficulty == 1) url += "medium";
     else url += "hard";
   }
+  CanvasHeapRelief heapRelief;
   HTTPClient http;
   WiFiClientSecure client;
   client.setInsecure();
@@ -2525,7 +5156,7 @@ void parseQuizQuestions(String jsonData) {
     allAnswers[0] = q.correctAnswer;
     for (int i = 0; i < 3; i++) allAnswers[i+1] = (i < incorrect.size()) ? urlDecode(incorrect[i].as<String>()) : "";
     for (int i = 3; i > 0; i--) {
-      int j = random(i + 1);
+      int j = rngBelow(rngGame, i + 1);
       String temp = allAnswers[i];
       allAnswers[i] = allAnswers[j];
       allAnswers[j] = temp;
@@ -2624,8 +5255,6 @@ void drawQuizMenu() {
     canvas.setCursor(50, y + 2);
     canvas.print(items[i]);
   }
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 String getDifficultyName(int diff) { return (diff == 0) ? "Easy" : (diff == 1 ? "Medium" : (diff == 2 ? "Hard" : "Mixed")); }
@@ -2692,22 +5321,13 @@ void drawQuizPlaying() {
   canvas.setTextSize(1); canvas.setTextColor(COLOR_DIM);
   canvas.setCursor(10, SCREEN_HEIGHT - 12);
   canvas.print("L=Lifeline  R=Menu  L+R=Back  50/50:" + String(quiz.lifeline5050) + " Skip:" + String(quiz.lifelineSkip));
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 int drawWordWrap(String text, int x, int y, int maxWidth, uint16_t color) {
-  canvas.setTextColor(color);
-  int curX = x;
-  String word = "";
-  for (int i = 0; i <= text.length(); i++) {
-    if (i == text.length() || text[i] == ' ') {
-      if (curX + word.length() * 6 > x + maxWidth) { y += 10; curX = x; }
-      canvas.setCursor(curX, y); canvas.print(word + " ");
-      curX += (word.length() + 1) * 6; word = "";
-    } else word += text[i];
-  }
-  return y + 10;
+  static TextLayout layout;
+  textLayoutSync(layout, text, textLayoutHash(text), 1, maxWidth, 10, false, INT32_MAX);
+  textLayoutDraw(layout, text, x, y, INT16_MIN, INT16_MAX, color);
+  return y + textLayoutLastY(layout) + 10;
 }
 
 void drawQuizResult() {
@@ -2746,8 +5366,6 @@ void drawQuizResult() {
   canvas.setTextColor(COLOR_ACCENT);
   canvas.setCursor(70, SCREEN_HEIGHT - 25); canvas.print("Press SELECT to play again");
   canvas.setCursor(90, SCREEN_HEIGHT - 12); canvas.print("Press L+R to Exit");
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawQuizLeaderboard() {
@@ -2788,8 +5406,6 @@ void drawQuizLeaderboard() {
 
   canvas.setTextColor(COLOR_DIM);
   canvas.setCursor(110, SCREEN_HEIGHT - 12); canvas.print("Press SELECT to back");
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 // ===== GAME LOGIC =====
@@ -2829,11 +5445,11 @@ void use5050() {
 
 void useSkip() { if (quiz.lifelineSkip-- > 0 && quiz.state == QUIZ_SELECTING) { quiz.skipped++; quiz.streak = 0; nextQuestion(); } }
 
-// ===== INPUT HANDLERS (USING digitalRead) =====
+// ===== INPUT HANDLERS (BUTTON EVENTS) =====
 void handleQuizMenuInput() {
-  if (digitalRead(BTN_DOWN) == BTN_ACT) { quizMenuCursor = (quizMenuCursor + 1) % 7; delay(150); screenIsDirty = true; }
-  if (digitalRead(BTN_UP) == BTN_ACT) { quizMenuCursor = (quizMenuCursor + 6) % 7; delay(150); screenIsDirty = true; }
-  if (digitalRead(BTN_SELECT) == BTN_ACT) {
+  if (buttonHit(BTN_DOWN)) { quizMenuCursor = (quizMenuCursor + 1) % 7; screenIsDirty = true; }
+  if (buttonHit(BTN_UP)) { quizMenuCursor = (quizMenuCursor + 6) % 7; screenIsDirty = true; }
+  if (buttonHit(BTN_SELECT)) {
     switch (quizMenuCursor) {
       case 0: initQuizGame(); break;
       case 1: { static int c = 0; c = (c + 1) % quizCategoryCount; quizSettings.categoryId = quizCategories[c].id; quizSettings.categoryName = quizCategories[c].name; break; }
@@ -2858,22 +5474,22 @@ void handleQuizMenuInput() {
       case 5: loadLeaderboard(); changeState(STATE_QUIZ_LEADERBOARD); break;
       case 6: changeState(STATE_MAIN_MENU); break;
     }
-    delay(200); screenIsDirty = true;
+    screenIsDirty = true;
   }
 }
 
 void handleQuizPlayingInput() {
   updateQuizTimer();
-  if (quiz.state == QUIZ_ANSWERED || quiz.state == QUIZ_TIMESUP) { if (digitalRead(BTN_SELECT) == BTN_ACT) { nextQuestion(); delay(200); screenIsDirty = true; } return; }
-  if (digitalRead(BTN_UP) == BTN_ACT) { do { quiz.selectedAnswer = (quiz.selectedAnswer + 3) % 4; } while (quiz.questions[quiz.currentQuestion].answers[quiz.selectedAnswer] == ""); delay(150); screenIsDirty = true; }
-  if (digitalRead(BTN_DOWN) == BTN_ACT) { do { quiz.selectedAnswer = (quiz.selectedAnswer + 1) % 4; } while (quiz.questions[quiz.currentQuestion].answers[quiz.selectedAnswer] == ""); delay(150); screenIsDirty = true; }
-  if (digitalRead(BTN_SELECT) == BTN_ACT) { submitAnswer(quiz.selectedAnswer); delay(200); screenIsDirty = true; }
-  if (digitalRead(BTN_LEFT) == BTN_ACT) { if (quiz.lifeline5050 > 0) use5050(); else if (quiz.lifelineSkip > 0) useSkip(); delay(200); screenIsDirty = true; }
-  if (digitalRead(BTN_RIGHT) == BTN_ACT) { changeState(STATE_QUIZ_MENU); delay(200); screenIsDirty = true; }
+  if (quiz.state == QUIZ_ANSWERED || quiz.state == QUIZ_TIMESUP) { if (buttonHit(BTN_SELECT)) { nextQuestion(); screenIsDirty = true; } return; }
+  if (buttonHit(BTN_UP)) { do { quiz.selectedAnswer = (quiz.selectedAnswer + 3) % 4; } while (quiz.questions[quiz.currentQuestion].answers[quiz.selectedAnswer] == ""); screenIsDirty = true; }
+  if (buttonHit(BTN_DOWN)) { do { quiz.selectedAnswer = (quiz.selectedAnswer + 1) % 4; } while (quiz.questions[quiz.currentQuestion].answers[quiz.selectedAnswer] == ""); screenIsDirty = true; }
+  if (buttonHit(BTN_SELECT)) { submitAnswer(quiz.selectedAnswer); screenIsDirty = true; }
+  if (buttonHit(BTN_LEFT)) { if (quiz.lifeline5050 > 0) use5050(); else if (quiz.lifelineSkip > 0) useSkip(); screenIsDirty = true; }
+  if (buttonHit(BTN_RIGHT)) { changeState(STATE_QUIZ_MENU); screenIsDirty = true; }
 }
 
-void handleQuizResultInput() { if (digitalRead(BTN_SELECT) == BTN_ACT) { initQuizGame(); delay(200); screenIsDirty = true; } }
-void handleQuizLeaderboardInput() { if (digitalRead(BTN_SELECT) == BTN_ACT) { changeState(STATE_QUIZ_MENU); delay(200); screenIsDirty = true; } }
+void handleQuizResultInput() { if (buttonHit(BTN_SELECT)) { initQuizGame(); screenIsDirty = true; } }
+void handleQuizLeaderboardInput() { if (buttonHit(BTN_SELECT)) { changeState(STATE_QUIZ_MENU); screenIsDirty = true; } }
 
 
 // ===== QIBLA CALCULATOR =====
@@ -3043,43 +5659,23 @@ void updateAndDrawSmokeVisualizer() {
         particlesToSpawn = map(musicVol, 0, 30, 1, 5);
     }
 
-    for (int i = 0; i < NUM_SMOKE_PARTICLES && particlesToSpawn > 0; i++) {
-        if (smokeParticles[i].life <= 0) {
-            smokeParticles[i].x = random(0, SCREEN_WIDTH);
-            smokeParticles[i].y = SCREEN_HEIGHT + 5; // Start just below the screen
-            smokeParticles[i].vx = random(-5, 5) / 10.0f; // Gentle horizontal drift
-
-            // Speed based on tempo (simulated with volume)
-            float speedFactor = map(musicVol, 0, 30, 10, 20) / 10.0f;
-            smokeParticles[i].vy = - (random(5, 12) / 10.0f) * speedFactor;
-
-            smokeParticles[i].maxLife = random(80, 150);
-            smokeParticles[i].life = smokeParticles[i].maxLife;
-            smokeParticles[i].size = random(1, 4);
-            particlesToSpawn--;
-        }
+    // Shed load right away when quality drops
+    particlesSetLimit(smokeParticles, qualityScaleCount(NUM_SMOKE_PARTICLES));
+    // Speed based on tempo (simulated with volume)
+    float speedFactor = map(musicVol, 0, 30, 10, 20) / 10.0f;
+    for (; particlesToSpawn > 0; particlesToSpawn--) {
+        float x = rngRange(rngEffects, 0, SCREEN_WIDTH);
+        float vx = rngRange(rngEffects, -5, 5) / 10.0f; // Gentle horizontal drift
+        float vy = - (rngRange(rngEffects, 5, 12) / 10.0f) * speedFactor;
+        uint16_t life = rngRange(rngEffects, 80, 150);
+        uint8_t size = rngRange(rngEffects, 1, 4);
+        // Start just below the screen; dies once it rises off the top
+        if (!particleSpawn(smokeParticles, x, SCREEN_HEIGHT + 5, vx, vy, life, 0x7BCF, size)) break;
     }
 
     // 2. Update and draw existing particles
-    for (int i = 0; i < NUM_SMOKE_PARTICLES; i++) {
-        if (smokeParticles[i].life > 0) {
-            smokeParticles[i].x += smokeParticles[i].vx;
-            smokeParticles[i].y += smokeParticles[i].vy;
-            smokeParticles[i].life--;
-
-            // Reset if it goes off-screen
-            if (smokeParticles[i].y < 0) {
-                smokeParticles[i].life = 0;
-            }
-
-            // Fade out effect
-            float lifePercent = (float)smokeParticles[i].life / smokeParticles[i].maxLife;
-            uint8_t alpha = lifePercent * 100 + 20; // Fade from gray to darker gray
-            uint16_t color = color565(alpha, alpha, alpha);
-
-            canvas.fillCircle(smokeParticles[i].x, smokeParticles[i].y, smokeParticles[i].size, color);
-        }
-    }
+    particlesUpdate(smokeParticles);
+    particlesDraw(smokeParticles);
 }
 
 void drawGradientVLine(int16_t x, int16_t y, int16_t h, uint16_t color1, uint16_t color2) {
@@ -3088,18 +5684,18 @@ void drawGradientVLine(int16_t x, int16_t y, int16_t h, uint16_t color1, uint16_
         canvas.drawPixel(x, y, color1);
         return;
     }
-    uint8_t r1 = (color1 >> 11) & 0x1F;
-    uint8_t g1 = (color1 >> 5) & 0x3F;
-    uint8_t b1 = color1 & 0x1F;
-    int8_t r2 = (color2 >> 11) & 0x1F;
-    int8_t g2 = (color2 >> 5) & 0x3F;
-    int8_t b2 = color2 & 0x1F;
-
-    for (int16_t i = 0; i < h; i++) {
-        uint8_t r = r1 + (r2 - r1) * i / (h - 1);
-        uint8_t g = g1 + (g2 - g1) * i / (h - 1);
-        uint8_t b = b1 + (b2 - b1) * i / (h - 1);
-        canvas.drawPixel(x, y + i, (r << 11) | (g << 5) | b);
+    int16_t y0 = y, fullH = h, w = 1;
+    if (!clipToScreen(x, y, w, h)) return;
+    uint16_t* dst = canvas.getBuffer() + (int32_t)y * SCREEN_WIDTH + x;
+    int r1 = (color1 >> 11) & 0x1F, g1 = (color1 >> 5) & 0x3F, b1 = color1 & 0x1F;
+    int r2 = (color2 >> 11) & 0x1F, g2 = (color2 >> 5) & 0x3F, b2 = color2 & 0x1F;
+    // c1 + delta * i / (h - 1) truncates descending channels toward c1, one
+    // level off from spanGradient565's rounding, so it stays its own loop
+    for (int16_t i = y - y0; i < y - y0 + h; i++, dst += SCREEN_WIDTH) {
+        int r = r1 + (r2 - r1) * i / (fullH - 1);
+        int g = g1 + (g2 - g1) * i / (fullH - 1);
+        int b = b1 + (b2 - b1) * i / (fullH - 1);
+        *dst = (r << 11) | (g << 5) | b;
     }
 }
 float custom_lerp(float a, float b, float f) {
@@ -3202,9 +5798,6 @@ void drawEnhancedMusicPlayer() {
         canvas.setCursor(iconX + 3, statusY-3);
         canvas.print("1");
     }
-
-
-    tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawEQIcon(int x, int y, uint8_t eqMode) {
@@ -3242,10 +5835,12 @@ void drawScrollableMenu(const char* items[], int numItems, int startY, int itemH
   }
 
   // Smooth Menu Scrolling
-  genericMenuScrollCurrent = custom_lerp(genericMenuScrollCurrent, targetScroll, 10.0f * deltaTime);
+  animSetOwner(genericMenuAnim, currentState);
+  animSetTarget(genericMenuAnim, targetScroll);
+  int scroll = (int)animValue(genericMenuAnim);
 
   for (int i = 0; i < numItems; i++) {
-    int y = startY + (i * (itemHeight + itemGap)) - (int)genericMenuScrollCurrent;
+    int y = startY + (i * (itemHeight + itemGap)) - scroll;
 
     if (y < startY - itemHeight || y > SCREEN_HEIGHT - 15) continue;
 
@@ -3351,6 +5946,16 @@ void onESPNowDataRecv(const esp_now_recv_info_t *recv_info, const uint8_t *data,
 void onESPNowDataRecv(const uint8_t *mac, const uint8_t *data, int len) {
 #endif
 
+  // Race snapshots arrive at 20 Hz: handle them before the chat bookkeeping
+  if (len == sizeof(RaceSyncPacket) && data[0] == 'S') {
+    RaceSyncPacket packet;
+    memcpy(&packet, data, sizeof(packet));
+    portENTER_CRITICAL(&raceSyncMux);
+    raceSyncReceive(raceSync, packet, millis());
+    portEXIT_CRITICAL(&raceSyncMux);
+    return;
+  }
+
   memcpy(&incomingMsg, data, sizeof(incomingMsg));
   
   Serial.print("ESP-NOW Received from: ");
@@ -3397,7 +6002,7 @@ void onESPNowDataRecv(const uint8_t *mac, const uint8_t *data, int len) {
       espnowMessages[espnowMessageCount].isFromMe = false;
       espnowMessageCount++;
       
-      chatAnimProgress = 0.0f; // Trigger animation
+      chatSlidePending = true; // Trigger animation
       triggerNeoPixelEffect(pixels.Color(100, 200, 255), 800);
       ledQuickFlash();
     }
@@ -3409,14 +6014,6 @@ void onESPNowDataRecv(const uint8_t *mac, const uint8_t *data, int len) {
     showStatus("Pet Found!\nHappiness +", 1500);
     myPet.happiness = min(myPet.happiness + 20.0f, 100.0f);
     savePetData();
-  } else if (incomingMsg.type == 'R') {
-    // Race Data
-    opponentCar.x = incomingMsg.raceData.x;
-    opponentCar.y = incomingMsg.raceData.y;
-    opponentCar.z = incomingMsg.raceData.z;
-    opponentCar.speed = incomingMsg.raceData.speed;
-    opponentPresent = true;
-    lastOpponentUpdate = millis();
   }
   
   if (currentState == STATE_ESPNOW_CHAT) {
@@ -3522,7 +6119,7 @@ void sendESPNowMessage(String message) {
       espnowMessages[espnowMessageCount].isFromMe = true;
       espnowMessageCount++;
       espnowAutoScroll = true;
-      chatAnimProgress = 0.0f; // Trigger animation
+      chatSlidePending = true; // Trigger animation
     }
   } else {
     showStatus("Send Failed!", 1000);
@@ -3564,8 +6161,8 @@ void drawESPNowChat() {
     
     // Animation Logic
     int animYOffset = 0;
-    if (i == espnowMessageCount - 1 && chatAnimProgress < 1.0f) {
-      animYOffset = (1.0f - chatAnimProgress) * 20; // Slide up effect
+    if (i == espnowMessageCount - 1 && (chatSlidePending || animMoving(chatSlideAnim))) {
+      animYOffset = (1.0f - animValue(chatSlideAnim)) * 20; // Slide up effect
     }
 
     int drawY = y + animYOffset;
@@ -3642,8 +6239,6 @@ void drawESPNowChat() {
   canvas.setTextColor(COLOR_DIM);
   canvas.setTextSize(1);
   canvas.setCursor(5, SCREEN_HEIGHT - 12);
-  
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 // ============ SYSTEM MONITOR FUNCTIONS ============
@@ -3765,8 +6360,6 @@ void drawSystemMonitor() {
   canvas.setTextColor(COLOR_DIM);
   canvas.setCursor(10, SCREEN_HEIGHT - 12);
   canvas.print(uptimeStr);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 
@@ -3804,8 +6397,6 @@ void drawWifiInfo() {
     canvas.setCursor(20, y + 10);
     canvas.print("WiFi is not connected.");
   }
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawStorageInfo() {
@@ -3837,8 +6428,6 @@ void drawStorageInfo() {
     canvas.setCursor(20, y + 10);
     canvas.print("SD Card not mounted.");
   }
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawBrightnessMenu() {
@@ -3875,9 +6464,6 @@ void drawBrightnessMenu() {
   canvas.getTextBounds(brightness_text, 0, 0, &x1, &y1, &w, &h);
   canvas.setCursor((SCREEN_WIDTH - w) / 2, barY + barH + 15);
   canvas.print(brightness_text);
-
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 // ============ SCREENSAVER ============
@@ -3922,8 +6508,6 @@ void drawScreensaver() {
     canvas.setCursor((SCREEN_WIDTH - w) / 2, (SCREEN_HEIGHT - h) / 2);
     canvas.print("Waiting for time sync...");
   }
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawSnakeGame() {
@@ -3975,16 +6559,12 @@ void drawSnakeGame() {
   }
 
   // Draw food (pulsing)
-  float pulse = sin(millis() * 0.01f) * 1.5f;
+  int pulse = fxMulQ15(fxSin(fxPhase(millis(), 628)), 3) / 2;
   canvas.fillCircle(food.x * SNAKE_GRID_SIZE + SNAKE_GRID_SIZE / 2, food.y * SNAKE_GRID_SIZE + SNAKE_GRID_SIZE / 2, SNAKE_GRID_SIZE / 2 - 1 + pulse, COLOR_ERROR); // Red
   canvas.fillCircle(food.x * SNAKE_GRID_SIZE + SNAKE_GRID_SIZE / 2, food.y * SNAKE_GRID_SIZE + SNAKE_GRID_SIZE / 2, SNAKE_GRID_SIZE / 2 - 3 + pulse, COLOR_WARN); // Yellow core
 
   // Draw particles
-  for (int i = 0; i < MAX_SNAKE_PARTICLES; i++) {
-    if (snakeParticles[i].life > 0) {
-      canvas.drawPixel(snakeParticles[i].x, snakeParticles[i].y, snakeParticles[i].color);
-    }
-  }
+  particlesDraw(snakeParticles);
 
   // Draw score
   canvas.setTextSize(1);
@@ -4007,8 +6587,6 @@ void drawSnakeGame() {
 
     canvas.setTextSize(1);
   }
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 
@@ -4029,6 +6607,103 @@ void drawScaledBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, in
   }
 }
 
+// ============ ICON SPRITE CACHE ============
+// Menu icons pre-scaled at quantized scales (1/ICON_SCALE_QUANT steps) and
+// stored as horizontal runs (row, x, len). The icons are 1-bit, so a sprite is
+// pure coverage and the tint is applied at blit time: one spanFill565 per run
+// instead of a float divide, pgm_read_byte and drawPixel per output pixel.
+#define ICON_SRC_SIZE 32
+#define ICON_SCALE_QUANT 16
+#define ICON_SCALE_MAX_STEP 24   // 1.5x, covers the pulsing selected icon
+#define NUM_MENU_ICONS (sizeof(menuIcons) / sizeof(menuIcons[0]))
+
+struct IconSprite {
+  uint8_t* runs;      // runCount triples of (row, x, len)
+  uint16_t runCount;
+  bool built;
+};
+
+IconSprite iconSprites[NUM_MENU_ICONS][ICON_SCALE_MAX_STEP + 1];
+
+// Rasterize icon `idx` at scale step/ICON_SCALE_QUANT with the same nearest
+// sampling drawScaledBitmap uses. Returns false if the run buffer can't be had.
+bool buildIconSprite(uint8_t idx, uint8_t step) {
+  IconSprite& s = iconSprites[idx][step];
+  const uint8_t* bitmap = menuIcons[idx];
+  int16_t size = ICON_SRC_SIZE * step / ICON_SCALE_QUANT;
+
+  // Two passes: count runs, then allocate exactly and record them
+  uint8_t* out = nullptr;
+  uint16_t count = 0;
+  for (int pass = 0; pass < 2; pass++) {
+    count = 0;
+    for (int16_t j = 0; j < size; j++) {
+      int16_t srcY = j * ICON_SCALE_QUANT / step;
+      const uint8_t* srcRow = bitmap + srcY * (ICON_SRC_SIZE / 8);
+      int16_t runStart = -1;
+      for (int16_t i = 0; i <= size; i++) {
+        bool on = false;
+        if (i < size) {
+          int16_t srcX = i * ICON_SCALE_QUANT / step;
+          on = pgm_read_byte(&srcRow[srcX >> 3]) & (128 >> (srcX & 7));
+        }
+        if (on && runStart < 0) {
+          runStart = i;
+        } else if (!on && runStart >= 0) {
+          if (out) {
+            out[count * 3] = j;
+            out[count * 3 + 1] = runStart;
+            out[count * 3 + 2] = i - runStart;
+          }
+          count++;
+          runStart = -1;
+        }
+      }
+    }
+    if (pass == 0) {
+      if (count == 0) break;
+      out = (uint8_t*)malloc(count * 3);
+      if (out == nullptr) return false;
+    }
+  }
+
+  s.runs = out;
+  s.runCount = count;
+  s.built = true;
+  return true;
+}
+
+// Draw menu icon `idx` centered on (cx, cy) at the nearest cached scale.
+void drawIconSprite(int16_t cx, int16_t cy, uint8_t idx, float scale, uint16_t color) {
+  if (idx >= NUM_MENU_ICONS) return;
+  int step = (int)(scale * ICON_SCALE_QUANT + 0.5f);
+  if (step <= 0) return;
+  if (step > ICON_SCALE_MAX_STEP) step = ICON_SCALE_MAX_STEP;
+
+  IconSprite& s = iconSprites[idx][step];
+  int16_t size = ICON_SRC_SIZE * step / ICON_SCALE_QUANT;
+  int16_t x0 = cx - size / 2;
+  int16_t y0 = cy - size / 2;
+  if (!s.built && !buildIconSprite(idx, step)) {
+    drawScaledBitmap(x0, y0, menuIcons[idx], ICON_SRC_SIZE, ICON_SRC_SIZE, (float)step / ICON_SCALE_QUANT, color);
+    return;
+  }
+  if (x0 >= SCREEN_WIDTH || y0 >= SCREEN_HEIGHT || x0 + size <= 0 || y0 + size <= 0) return;
+
+  uint16_t* buf = canvas.getBuffer();
+  const uint8_t* r = s.runs;
+  for (uint16_t n = 0; n < s.runCount; n++, r += 3) {
+    int16_t y = y0 + r[0];
+    if (y < 0 || y >= SCREEN_HEIGHT) continue;
+    int16_t x = x0 + r[1];
+    int16_t len = r[2];
+    if (x < 0) { len += x; x = 0; }
+    if (x + len > SCREEN_WIDTH) len = SCREEN_WIDTH - x;
+    if (len <= 0) continue;
+    spanFill565(buf + (int32_t)y * SCREEN_WIDTH + x, len, color);
+  }
+}
+
 // New function for drawing scaled 16-bit color bitmaps
 void drawScaledColorBitmap(int16_t x, int16_t y, const uint16_t *bitmap, int16_t w, int16_t h, float scale) {
   if (scale <= 0) return;
@@ -4079,8 +6754,6 @@ void drawRacingModeSelect() {
 
   const char* items[] = {"1 Player (vs AI)", "2 Player (ESP-NOW)", "Back"};
   drawScrollableMenu(items, 3, 45, 30, 5);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 // ============ VISUAL EFFECTS ============
@@ -4124,8 +6797,6 @@ void drawDeauthAttack() {
   canvas.setTextSize(1);
   canvas.setCursor(10, SCREEN_HEIGHT - 12);
   canvas.print("ATTACKING...");
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawDeauthSelect() {
@@ -4190,8 +6861,6 @@ void drawDeauthSelect() {
   canvas.setTextColor(COLOR_DIM);
   canvas.setTextSize(1);
   canvas.setCursor(10, SCREEN_HEIGHT - 12);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void updateDeauthAttack() {
@@ -4242,8 +6911,6 @@ void drawHackerToolsMenu() {
 
   const char* items[] = {"WiFi Deauther", "SSID Spammer", "Probe Sniffer", "Packet Monitor", "BLE Spammer", "Deauth Detector", "Back"};
   drawScrollableMenu(items, 7, 40, 22, 3);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawGameHubMenu() {
@@ -4261,16 +6928,14 @@ void drawGameHubMenu() {
 
   const char* items[] = {"Racing", "Pong", "Snake", "Jumper", "Flappy ESP", "Breakout", "Starfield Warp", "Game of Life", "Doom Fire", "Back"};
   drawScrollableMenu(items, 10, 45, 22, 2);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawStarfield() {
   if (!starsInit) {
     for(int i=0; i<NUM_STARS; i++) {
-      stars[i].x = random(-SCREEN_WIDTH, SCREEN_WIDTH);
-      stars[i].y = random(-SCREEN_HEIGHT, SCREEN_HEIGHT);
-      stars[i].z = random(10, 255);
+      stars[i].x = rngRange(rngEffects, -SCREEN_WIDTH, SCREEN_WIDTH);
+      stars[i].y = rngRange(rngEffects, -SCREEN_HEIGHT, SCREEN_HEIGHT);
+      stars[i].z = rngRange(rngEffects, 10, 255);
     }
     starsInit = true;
   }
@@ -4279,14 +6944,15 @@ void drawStarfield() {
   int cx = SCREEN_WIDTH / 2;
   int cy = SCREEN_HEIGHT / 2;
   float speed = 4.0f;
-  if (digitalRead(BTN_UP) == BTN_ACT) speed = 8.0f;
-  if (digitalRead(BTN_DOWN) == BTN_ACT) speed = 2.0f;
+  if (buttonHeld(BTN_UP)) speed = 8.0f;
+  if (buttonHeld(BTN_DOWN)) speed = 2.0f;
 
-  for(int i=0; i<NUM_STARS; i++) {
+  int activeStars = qualityScaleCount(NUM_STARS);
+  for(int i=0; i<activeStars; i++) {
     stars[i].z -= speed;
     if (stars[i].z <= 0) {
-       stars[i].x = random(-SCREEN_WIDTH, SCREEN_WIDTH);
-       stars[i].y = random(-SCREEN_HEIGHT, SCREEN_HEIGHT);
+       stars[i].x = rngRange(rngEffects, -SCREEN_WIDTH, SCREEN_WIDTH);
+       stars[i].y = rngRange(rngEffects, -SCREEN_HEIGHT, SCREEN_HEIGHT);
        stars[i].z = 255;
     }
 
@@ -4304,15 +6970,13 @@ void drawStarfield() {
   canvas.setTextColor(COLOR_DIM);
   canvas.setTextSize(1);
   canvas.setCursor(10, 10);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawGameOfLife() {
   if (!lifeInit) {
     for(int x=0; x<LIFE_W; x++) {
        for(int y=0; y<LIFE_H; y++) {
-          lifeGrid[x][y] = random(0, 2);
+          lifeGrid[x][y] = rngRange(rngEffects, 0, 2);
        }
     }
     lifeInit = true;
@@ -4343,7 +7007,7 @@ void drawGameOfLife() {
     lastLifeUpdate = millis();
 
     // Auto reset check (crude)
-    if(random(0, 500) == 0) lifeInit = false;
+    if(rngRange(rngEffects, 0, 500) == 0) lifeInit = false;
   }
 
   canvas.fillScreen(COLOR_BG);
@@ -4355,13 +7019,11 @@ void drawGameOfLife() {
     }
   }
 
-  if (digitalRead(BTN_SELECT) == BTN_ACT) lifeInit = false; // Manual reset
+  if (buttonHit(BTN_SELECT)) lifeInit = false; // Manual reset
 
   canvas.setTextColor(COLOR_DIM);
   canvas.setTextSize(1);
   canvas.setCursor(10, 10);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawFireEffect() {
@@ -4380,7 +7042,7 @@ void drawFireEffect() {
 
   // Seed bottom row
   for(int x=0; x<FIRE_W; x++) {
-     firePixels[(FIRE_H-1)*FIRE_W + x] = random(0, 37); // Max heat
+     firePixels[(FIRE_H-1)*FIRE_W + x] = rngRange(rngEffects, 0, 37); // Max heat
   }
 
   // Propagate
@@ -4391,7 +7053,7 @@ void drawFireEffect() {
         if (pixel == 0) {
            firePixels[(y-1)*FIRE_W + x] = 0;
         } else {
-           int randIdx = random(0, 3);
+           int randIdx = rngRange(rngEffects, 0, 3);
            int dst = (y-1)*FIRE_W + (x - randIdx + 1);
            if(dst >= 0 && dst < FIRE_W*FIRE_H) {
               firePixels[dst] = max(0, pixel - (randIdx & 1));
@@ -4416,8 +7078,6 @@ void drawFireEffect() {
 
   canvas.setTextColor(COLOR_TEXT);
   canvas.setCursor(10, 10);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 // ============ RACING GAME V3 LOGIC & DRAWING ============
@@ -4425,43 +7085,70 @@ void generateTrack() {
   totalSegments = 0;
   sceneryCount = 0;
 
-  // Use a fixed seed for consistent track generation if needed,
-  // or random for more variety. Let's go with variety!
-  randomSeed(millis());
+  // Drawn from the track stream: reseed rngTrack first to rebuild a given track
 
   // Generate a procedural track
-  for (int i = 0; i < 40; i++) {
-      int len = random(30, 80);
+  for (int i = 0; i < RACE_TRACK_SEGMENTS; i++) {
+      int len = rngRange(rngTrack, 30, 80);
       float curve = 0;
       float hill = 0;
       RoadSegmentType type = STRAIGHT;
 
-      int r = random(0, 10);
+      int r = rngRange(rngTrack, 0, 10);
       if (r < 4) {
           type = STRAIGHT;
       } else if (r < 7) {
           type = CURVE;
-          curve = (random(-15, 16) / 10.0f);
+          curve = (rngRange(rngTrack, -15, 16) / 10.0f);
       } else {
           type = HILL;
-          hill = (random(-8, 9) / 10.0f);
+          hill = (rngRange(rngTrack, -8, 9) / 10.0f);
       }
 
       track[totalSegments++] = {type, curve, hill, len};
       if (totalSegments >= MAX_ROAD_SEGMENTS) break;
   }
 
-  // Scattered scenery along the track
-  for (int i = 5; i < totalSegments; i++) {
-      if (random(0, 10) > 6) {
-          float side = (random(0, 2) == 0) ? -2.0f : 2.0f;
-          SceneryType st = (SceneryType)random(0, 3);
-          scenery[sceneryCount++] = {st, side, (float)i * SEGMENT_STEP_LENGTH};
-          if (sceneryCount >= MAX_SCENERY) break;
+  // Prefix sums, so lookups never walk the track from the start
+  trackStartZ[0] = 0;
+  trackStartX[0] = 0;
+  for (int i = 0; i < totalSegments; i++) {
+      trackStartZ[i + 1] = trackStartZ[i] + track[i].length * SEGMENT_STEP_LENGTH;
+      trackStartX[i + 1] = trackStartX[i] + track[i].curvature * track[i].length;
+  }
+
+  // Scattered scenery along the track, one possible object at the start of each segment
+  for (int i = 0; i <= totalSegments; i++) {
+      sceneryFirst[i] = sceneryCount;
+      if (i < 5 || i == totalSegments || sceneryCount >= MAX_SCENERY) continue;
+      if (rngRange(rngTrack, 0, 10) > 6) {
+          float side = (rngRange(rngTrack, 0, 2) == 0) ? -2.0f : 2.0f;
+          SceneryType st = (SceneryType)rngRange(rngTrack, 0, 3);
+          scenery[sceneryCount++] = {st, side, (float)trackStartZ[i]};
       }
   }
 }
 
+int32_t trackLengthZ() {
+  return trackStartZ[totalSegments];
+}
+
+// Segment holding z: the first one ending at or after it, else the last
+int trackSegmentAt(float z) {
+  int lo = 0, hi = totalSegments - 1;
+  while (lo < hi) {
+      int mid = (lo + hi) / 2;
+      if (trackStartZ[mid + 1] < z) lo = mid + 1;
+      else hi = mid;
+  }
+  return lo;
+}
+
+// Road centre offset at z within segment seg, in curvature * steps
+float trackCurveX(int seg, float z) {
+  return trackStartX[seg] + track[seg].curvature * ((z - trackStartZ[seg]) / SEGMENT_STEP_LENGTH);
+}
+
 void updateRacingLogic() {
     if (!racingGameActive) {
         // Reset player and AI cars
@@ -4469,31 +7156,34 @@ void updateRacingLogic() {
         aiCar = {0.5, 0, 10, 80, 0, 0}; // Start AI with some speed
         opponentCar = {0, 0, 0, 0, 0, 0};
         opponentPresent = false;
+        uint32_t seed = esp_random();
+        portENTER_CRITICAL(&raceSyncMux);
+        raceSyncReset(raceSync);
+        raceSync.trackSeed = seed;
+        portEXIT_CRITICAL(&raceSyncMux);
 
+        if (raceGameMode == RACE_MODE_MULTI) rngSeed(rngTrack, seed);
         generateTrack();
 
         racingGameActive = true;
     }
 
-    float dt = (millis() - lastRaceUpdate) / 1000.0f;
-    if (dt > 0.1f) dt = 0.1f;
-    lastRaceUpdate = millis();
+    const float dt = SIM_DT;
+    cameraPrev = camera;
+    aiCarPrev = aiCar;
+    opponentCarPrev = opponentCar;
 
     // --- Player Input ---
-    if (digitalRead(BTN_UP) == BTN_ACT) playerCar.speed += 150.0f * dt; // Faster acceleration
+    if (gameButton(BTN_UP)) playerCar.speed += 150.0f * dt; // Faster acceleration
     else playerCar.speed -= 50.0f * dt; // Natural deceleration
-    if (digitalRead(BTN_DOWN) == BTN_ACT) playerCar.speed -= 200.0f * dt; // Stronger brake
+    if (gameButton(BTN_DOWN)) playerCar.speed -= 200.0f * dt; // Stronger brake
 
     playerCar.speed = constrain(playerCar.speed, 0, 250); // Higher top speed
 
-    // --- Track Length Calculation ---
-    int totalTrackLength = 0;
-    for(int i = 0; i < totalSegments; i++) {
-        totalTrackLength += track[i].length * SEGMENT_STEP_LENGTH;
-    }
+    int32_t totalTrackLength = trackLengthZ();
 
     // --- Physics ---
-    playerCar.z += playerCar.speed * dt * 5.0f; // Scale speed to Z movement
+    playerCar.z += playerCar.speed * dt * RACE_Z_PER_SPEED; // Scale speed to Z movement
 
     // Lap Counter
     if (playerCar.z >= totalTrackLength) {
@@ -4513,12 +7203,7 @@ void updateRacingLogic() {
 
 
     // Find player's current segment
-    int playerSegmentIndex = 0;
-    float trackZ = 0;
-    while(playerSegmentIndex < totalSegments - 1 && trackZ + (track[playerSegmentIndex].length * SEGMENT_STEP_LENGTH) < playerCar.z) {
-        trackZ += track[playerSegmentIndex].length * SEGMENT_STEP_LENGTH;
-        playerSegmentIndex++;
-    }
+    int playerSegmentIndex = trackSegmentAt(playerCar.z);
     RoadSegment playerSegment = track[playerSegmentIndex];
 
     // Apply curvature force (centrifugal)
@@ -4530,8 +7215,8 @@ void updateRacingLogic() {
     float steerForce = 0;
     // Harder to turn at high speed, easier at low speed
     float steerSensitivity = 4.0f + (playerCar.speed / 50.0f);
-    if (digitalRead(BTN_LEFT) == BTN_ACT) steerForce = -steerSensitivity;
-    if (digitalRead(BTN_RIGHT) == BTN_ACT) steerForce = steerSensitivity;
+    if (gameButton(BTN_LEFT)) steerForce = -steerSensitivity;
+    if (gameButton(BTN_RIGHT)) steerForce = steerSensitivity;
 
     // Centrifugal effect increases with speed squared
     playerCar.x += steerForce * dt;
@@ -4545,8 +7230,10 @@ void updateRacingLogic() {
         playerCar.speed *= 0.99; // Gentler off-road penalty
         if (playerCar.speed > 30) screenShake = max(screenShake, 1.5f);
 
-        // Check for collision with scenery
-        for (int i = 0; i < sceneryCount; i++) {
+        // Check for collision with scenery in the segments just ahead
+        int first = sceneryFirst[playerSegmentIndex];
+        int last = sceneryFirst[min(trackSegmentAt(playerCar.z + 200) + 2, totalSegments)];
+        for (int i = first; i < last; i++) {
             float dz = scenery[i].z - playerCar.z;
             if (dz > 0 && dz < 200) { // Check only objects in front
                 if (abs(scenery[i].x - playerCar.x) < 0.5f) {
@@ -4566,19 +7253,13 @@ void updateRacingLogic() {
 
 
     // --- AI Logic ---
-    aiCar.z += aiCar.speed * dt * 5.0f;
+    aiCar.z += aiCar.speed * dt * RACE_Z_PER_SPEED;
     if (aiCar.z >= totalTrackLength) {
         aiCar.z -= totalTrackLength;
     }
 
     // Find AI's current segment
-    int aiSegmentIndex = 0;
-    trackZ = 0;
-    while(aiSegmentIndex < totalSegments - 1 && trackZ + (track[aiSegmentIndex].length * SEGMENT_STEP_LENGTH) < aiCar.z) {
-        trackZ += track[aiSegmentIndex].length * SEGMENT_STEP_LENGTH;
-        aiSegmentIndex++;
-    }
-    RoadSegment aiSegment = track[aiSegmentIndex];
+    RoadSegment aiSegment = track[trackSegmentAt(aiCar.z)];
 
     // Simple AI: try to stay in the middle, counteracting curvature
     float targetX = -aiSegment.curvature * 0.4;
@@ -4588,11 +7269,35 @@ void updateRacingLogic() {
 
     // --- Multiplayer ---
     if (raceGameMode == RACE_MODE_MULTI) {
-        outgoingMsg.type = 'R';
-        outgoingMsg.raceData = {playerCar.x, playerCar.y, playerCar.z, playerCar.speed};
-        esp_now_send(broadcastAddress, (uint8_t *)&outgoingMsg, sizeof(outgoingMsg));
+        portENTER_CRITICAL(&raceSyncMux);
+        bool rebuild = raceSyncAdoptTrack(raceSync);
+        uint32_t seed = raceSync.trackSeed;
+        portEXIT_CRITICAL(&raceSyncMux);
+        if (rebuild) {
+            // Peer's seed is lower: race on its track
+            rngSeed(rngTrack, seed);
+            generateTrack();
+            playerCar.z = fmodf(playerCar.z, trackLengthZ());
+            aiCar.z = fmodf(aiCar.z, trackLengthZ());
+        }
 
-        if (millis() - lastOpponentUpdate > 2000) opponentPresent = false;
+        RacePacket me = {playerCar.x, playerCar.y, playerCar.z, playerCar.speed};
+        RacePacket them;
+        RaceSyncPacket packet;
+        uint32_t now = millis();
+        bool wasPresent = opponentPresent;
+        portENTER_CRITICAL(&raceSyncMux);
+        bool send = raceSyncPrepare(raceSync, now, me, packet);
+        opponentPresent = raceSyncSample(raceSync, now, trackLengthZ(), them);
+        portEXIT_CRITICAL(&raceSyncMux);
+        if (send) esp_now_send(broadcastAddress, (uint8_t *)&packet, sizeof(packet));
+        if (opponentPresent) {
+            opponentCar.x = them.x;
+            opponentCar.y = them.y;
+            opponentCar.z = them.z;
+            opponentCar.speed = them.speed;
+            if (!wasPresent) opponentCarPrev = opponentCar; // Appear in place, don't slide in
+        }
     }
 
     // --- Camera ---
@@ -4600,21 +7305,19 @@ void updateRacingLogic() {
     camera.z = playerCar.z;
     // Simple camera height adjustment for hills
     camera.y = 1500 + playerSegment.hill * 400;
+    if (fabsf(camera.z - cameraPrev.z) > trackLengthZ() / 2) cameraPrev = camera; // Lap wrap
+    if (fabsf(aiCar.z - aiCarPrev.z) > trackLengthZ() / 2) aiCarPrev = aiCar;
+    if (fabsf(opponentCar.z - opponentCarPrev.z) > trackLengthZ() / 2) opponentCarPrev = opponentCar;
 }
 
 // ============ JUMPER (PLATFORMER) GAME LOGIC & DRAWING ============
 void triggerJumperParticles(float x, float y) {
-  int particlesToSpawn = 5;
-  for (int i = 0; i < JUMPER_MAX_PARTICLES && particlesToSpawn > 0; i++) {
-    if (jumperParticles[i].life <= 0) {
-      jumperParticles[i].x = x + random(0, 20);
-      jumperParticles[i].y = y;
-      jumperParticles[i].vx = random(-15, 15) / 10.0f;
-      jumperParticles[i].vy = random(0, 20) / 10.0f;
-      jumperParticles[i].life = 30; // Lifetime in frames
-      jumperParticles[i].color = C_WHITE;
-      particlesToSpawn--;
-    }
+  for (int i = 0; i < 5; i++) {
+    float px = x + rngRange(rngParticles, 0, 20);
+    float vx = rngRange(rngParticles, -15, 15) / 10.0f;
+    float vy = rngRange(rngParticles, 0, 20) / 10.0f;
+    // Lifetime in frames; radius 2, then 1 for the last 15 frames
+    if (!particleSpawn(jumperParticles, px, y, vx, vy, 30, C_WHITE, 2)) break;
   }
 }
 
@@ -4626,17 +7329,19 @@ void initPlatformerGame() {
   jumperPlayer.x = SCREEN_WIDTH / 2;
   jumperPlayer.y = SCREEN_HEIGHT - 50;
   jumperPlayer.vy = JUMPER_LIFT;
+  jumperPlayerPrev = jumperPlayer;
+  jumperCameraYPrev = jumperCameraY;
 
   // Initial platforms
   // Buat platform pertama lebih lebar agar lebih mudah untuk pemula
   jumperPlatforms[0] = {SCREEN_WIDTH / 2 - 40, SCREEN_HEIGHT - 30, 80, PLATFORM_STATIC, true, 0};
   for (int i = 1; i < JUMPER_MAX_PLATFORMS; i++) {
     jumperPlatforms[i].y = (float)(SCREEN_HEIGHT - 100 - (i * 70));
-    jumperPlatforms[i].x = (float)random(0, SCREEN_WIDTH - 50);
+    jumperPlatforms[i].x = (float)rngRange(rngGame, 0, SCREEN_WIDTH - 50);
     jumperPlatforms[i].active = true;
 
     // Add different types of platforms right from the start
-    int randType = random(0, 10);
+    int randType = rngRange(rngGame, 0, 10);
     if (randType > 8) {
       jumperPlatforms[i].type = PLATFORM_BREAKABLE;
       jumperPlatforms[i].width = 50;
@@ -4644,45 +7349,48 @@ void initPlatformerGame() {
     } else if (randType > 6) {
       jumperPlatforms[i].type = PLATFORM_MOVING;
       jumperPlatforms[i].width = 60;
-      jumperPlatforms[i].speed = random(0, 2) == 0 ? 1.5f : -1.5f;
+      jumperPlatforms[i].speed = rngRange(rngGame, 0, 2) == 0 ? 1.5f : -1.5f;
     } else {
       jumperPlatforms[i].type = PLATFORM_STATIC;
-      jumperPlatforms[i].width = random(40, 70);
+      jumperPlatforms[i].width = rngRange(rngGame, 40, 70);
       jumperPlatforms[i].speed = 0;
     }
   }
 
   // Clear particles
-  for(int i=0; i<JUMPER_MAX_PARTICLES; i++) jumperParticles[i].life = 0;
+  particlesClear(jumperParticles);
 
   // Init parallax stars
   for (int i = 0; i < JUMPER_MAX_STARS; i++) {
     jumperStars[i] = {
-      (float)random(0, SCREEN_WIDTH),
-      (float)random(0, SCREEN_HEIGHT),
-      (float)random(10, 50) / 100.0f, // Slower speeds for distant stars
-      (int)random(1, 3),
-      (uint16_t)random(0x39E7, 0x7BEF) // Shades of gray
+      (float)rngRange(rngEffects, 0, SCREEN_WIDTH),
+      (float)rngRange(rngEffects, 0, SCREEN_HEIGHT),
+      (float)rngRange(rngEffects, 10, 50) / 100.0f, // Slower speeds for distant stars
+      (int)rngRange(rngEffects, 1, 3),
+      (uint16_t)rngRange(rngEffects, 0x39E7, 0x7BEF) // Shades of gray
     };
   }
 }
 
 void updatePlatformerLogic() {
   if (!jumperGameActive) {
-    if (digitalRead(BTN_SELECT) == BTN_ACT) {
+    if (gameButton(BTN_SELECT)) {
       initPlatformerGame();
     }
     return;
   }
+  jumperPlayerPrev = jumperPlayer;
+  jumperCameraYPrev = jumperCameraY;
 
   // --- Player Input ---
+  // Speeds and gravity are per SIM_DT step
   float playerSpeed = 4.0f;
-  if (digitalRead(BTN_LEFT) == BTN_ACT) jumperPlayer.x -= playerSpeed;
-  if (digitalRead(BTN_RIGHT) == BTN_ACT) jumperPlayer.x += playerSpeed;
+  if (gameButton(BTN_LEFT)) jumperPlayer.x -= playerSpeed;
+  if (gameButton(BTN_RIGHT)) jumperPlayer.x += playerSpeed;
 
-  // Screen wrap
-  if (jumperPlayer.x < -10) jumperPlayer.x = SCREEN_WIDTH;
-  if (jumperPlayer.x > SCREEN_WIDTH) jumperPlayer.x = -10;
+  // Screen wrap, without blending across the screen
+  if (jumperPlayer.x < -10) jumperPlayerPrev.x = jumperPlayer.x = SCREEN_WIDTH;
+  if (jumperPlayer.x > SCREEN_WIDTH) jumperPlayerPrev.x = jumperPlayer.x = -10;
 
   // --- Physics ---
   jumperPlayer.vy += JUMPER_GRAVITY;
@@ -4725,21 +7433,21 @@ void updatePlatformerLogic() {
     if (jumperPlatforms[i].y > jumperCameraY + SCREEN_HEIGHT) {
       // This platform is below the screen, respawn it at the top
       jumperPlatforms[i].active = true;
-      jumperPlatforms[i].y = jumperCameraY - random(50, 100);
-      jumperPlatforms[i].x = random(0, SCREEN_WIDTH - 50);
+      jumperPlatforms[i].y = jumperCameraY - rngRange(rngGame, 50, 100);
+      jumperPlatforms[i].x = rngRange(rngGame, 0, SCREEN_WIDTH - 50);
 
       // Add different types of platforms
-      int randType = random(0, 10);
+      int randType = rngRange(rngGame, 0, 10);
       if (randType > 8) {
         jumperPlatforms[i].type = PLATFORM_BREAKABLE;
         jumperPlatforms[i].width = 50;
       } else if (randType > 6) {
         jumperPlatforms[i].type = PLATFORM_MOVING;
         jumperPlatforms[i].width = 60;
-        jumperPlatforms[i].speed = random(0, 2) == 0 ? 1.5f : -1.5f;
+        jumperPlatforms[i].speed = rngRange(rngGame, 0, 2) == 0 ? 1.5f : -1.5f;
       } else {
         jumperPlatforms[i].type = PLATFORM_STATIC;
-        jumperPlatforms[i].width = random(40, 70);
+        jumperPlatforms[i].width = rngRange(rngGame, 40, 70);
       }
     }
   }
@@ -4768,39 +7476,34 @@ void updatePlatformerLogic() {
     float starScreenY = jumperStars[i].y - (jumperCameraY * jumperStars[i].speed);
     if (starScreenY > SCREEN_HEIGHT) {
       jumperStars[i].y -= SCREEN_HEIGHT;
-      jumperStars[i].x = random(0, SCREEN_WIDTH);
+      jumperStars[i].x = rngRange(rngEffects, 0, SCREEN_WIDTH);
     } else if (starScreenY < 0) {
       jumperStars[i].y += SCREEN_HEIGHT;
-      jumperStars[i].x = random(0, SCREEN_WIDTH);
+      jumperStars[i].x = rngRange(rngEffects, 0, SCREEN_WIDTH);
     }
   }
 
   // --- Update Particles ---
-  for (int i = 0; i < JUMPER_MAX_PARTICLES; i++) {
-    if (jumperParticles[i].life > 0) {
-      jumperParticles[i].x += jumperParticles[i].vx;
-      jumperParticles[i].y += jumperParticles[i].vy;
-      jumperParticles[i].life--;
-    }
-  }
+  particlesUpdate(jumperParticles);
 }
 
 void drawPlatformerGame() {
   canvas.fillScreen(COLOR_BG);
+  float cameraY = simLerp(jumperCameraYPrev, jumperCameraY);
 
   // --- Draw Parallax Background ---
   for (int i = 0; i < JUMPER_MAX_STARS; i++) {
     // Stars move down relative to camera, creating parallax
-    float starScreenY = jumperStars[i].y - (jumperCameraY * jumperStars[i].speed);
+    float starScreenY = jumperStars[i].y - (cameraY * jumperStars[i].speed);
 
     // Wrap stars around
     while (starScreenY > SCREEN_HEIGHT) {
       starScreenY -= SCREEN_HEIGHT;
-      jumperStars[i].x = random(0, SCREEN_WIDTH); // Reposition X when wrapping
+      jumperStars[i].x = rngRange(rngEffects, 0, SCREEN_WIDTH); // Reposition X when wrapping
     }
     while (starScreenY < 0) {
       starScreenY += SCREEN_HEIGHT;
-      jumperStars[i].x = random(0, SCREEN_WIDTH);
+      jumperStars[i].x = rngRange(rngEffects, 0, SCREEN_WIDTH);
     }
 
     canvas.fillCircle(jumperStars[i].x, (int)starScreenY, jumperStars[i].size, jumperStars[i].color);
@@ -4815,24 +7518,18 @@ void drawPlatformerGame() {
         case PLATFORM_BREAKABLE: color = COLOR_ERROR; break; // Red
         default:                 color = COLOR_SUCCESS; break; // Green
       }
-      int screenY = jumperPlatforms[i].y - jumperCameraY;
+      int screenY = jumperPlatforms[i].y - cameraY;
       canvas.fillRect(jumperPlatforms[i].x, screenY, jumperPlatforms[i].width, 8, color);
       canvas.drawRect(jumperPlatforms[i].x, screenY, jumperPlatforms[i].width, 8, C_WHITE);
     }
   }
 
   // --- Draw Player ---
-  int playerScreenY = jumperPlayer.y - jumperCameraY;
-  drawScaledColorBitmap(jumperPlayer.x - 7, playerScreenY - 11, sprite_jumper_char, 14, 11, 1.0);
+  int playerScreenY = simLerp(jumperPlayerPrev.y, jumperPlayer.y) - cameraY;
+  drawScaledColorBitmap(simLerp(jumperPlayerPrev.x, jumperPlayer.x) - 7, playerScreenY - 11, sprite_jumper_char, 14, 11, 1.0);
 
   // --- Draw Particles ---
-  for (int i = 0; i < JUMPER_MAX_PARTICLES; i++) {
-    if (jumperParticles[i].life > 0) {
-      int particleScreenY = jumperParticles[i].y - jumperCameraY;
-      int size = (jumperParticles[i].life > 15) ? 2 : 1;
-      canvas.fillCircle(jumperParticles[i].x, particleScreenY, size, jumperParticles[i].color);
-    }
-  }
+  particlesDraw(jumperParticles, 0, -(int16_t)cameraY);
 
   // --- Draw Score ---
   canvas.setTextSize(2);
@@ -4873,38 +7570,90 @@ void drawPlatformerGame() {
     canvas.getTextBounds("SELECT to Restart | L+R to Exit", 0, 0, &x1, &y1, &w, &h);
     canvas.setCursor((SCREEN_WIDTH - w) / 2, SCREEN_HEIGHT/2 + 20);
   }
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 
+// Backdrop caches: the sky never changes, the mountain silhouette only
+// changes when the camera has moved a whole pixel of parallax.
+uint16_t racingSkyColors[SCREEN_HEIGHT / 2];
+bool racingSkyReady = false;
+
+struct MountainProfile {
+  int32_t shift; // Parallax offset in pixels
+  bool valid;
+  int16_t top[SCREEN_WIDTH];
+  int16_t height[SCREEN_WIDTH];
+};
+MountainProfile racingMountains = {0, false};
+
+void computeMountainColumn(int i) {
+  // 0.05 rad per column in Q8 binary angle; the uint32 wrap is a whole number of turns
+  uint16_t angle = ((uint32_t)(i + racingMountains.shift) * 133512u) >> 8;
+  int16_t m1 = fxMulQ15(fxSin(angle), 15) + 20;
+  racingMountains.top[i] = SCREEN_HEIGHT/2 - m1;
+  racingMountains.height[i] = m1;
+}
+
+void updateMountainProfile(int32_t shift) {
+  int32_t delta = shift - racingMountains.shift;
+  if (racingMountains.valid && delta == 0) return;
+
+  racingMountains.shift = shift;
+  if (racingMountains.valid && abs(delta) < SCREEN_WIDTH) {
+    // Scroll what we have and only evaluate the newly exposed columns
+    int keep = SCREEN_WIDTH - abs(delta);
+    if (delta > 0) {
+      memmove(racingMountains.top, racingMountains.top + delta, keep * sizeof(int16_t));
+      memmove(racingMountains.height, racingMountains.height + delta, keep * sizeof(int16_t));
+      for (int i = keep; i < SCREEN_WIDTH; i++) computeMountainColumn(i);
+    } else {
+      memmove(racingMountains.top - delta, racingMountains.top, keep * sizeof(int16_t));
+      memmove(racingMountains.height - delta, racingMountains.height, keep * sizeof(int16_t));
+      for (int i = 0; i < -delta; i++) computeMountainColumn(i);
+    }
+  } else {
+    for (int i = 0; i < SCREEN_WIDTH; i++) computeMountainColumn(i);
+  }
+  racingMountains.valid = true;
+}
+
 void drawRacingGame() {
+    PROF_LAP_BEGIN();
+    Camera view = {simLerp(cameraPrev.x, camera.x), simLerp(cameraPrev.y, camera.y), simLerp(cameraPrev.z, camera.z)};
     // --- Sky & Horizon ---
-    for(int y=0; y < SCREEN_HEIGHT/2; y++) {
-        uint8_t r = 20 + (y * 60) / (SCREEN_HEIGHT/2);
-        uint8_t g = 20 + (y * 80) / (SCREEN_HEIGHT/2);
-        uint8_t b = 100 + (y * 120) / (SCREEN_HEIGHT/2);
-        canvas.drawFastHLine(0, y, SCREEN_WIDTH, color565(r, g, b));
+    if (!racingSkyReady) {
+        for(int y=0; y < SCREEN_HEIGHT/2; y++) {
+            uint8_t r = 20 + (y * 60) / (SCREEN_HEIGHT/2);
+            uint8_t g = 20 + (y * 80) / (SCREEN_HEIGHT/2);
+            uint8_t b = 100 + (y * 120) / (SCREEN_HEIGHT/2);
+            racingSkyColors[y] = color565(r, g, b);
+        }
+        racingSkyReady = true;
+    }
+    uint16_t* skyRow = canvas.getBuffer();
+    for(int y=0; y < SCREEN_HEIGHT/2; y++, skyRow += SCREEN_WIDTH) {
+        spanFill565(skyRow, SCREEN_WIDTH, racingSkyColors[y]);
     }
     canvas.drawFastHLine(0, SCREEN_HEIGHT/2, SCREEN_WIDTH, 0x1082); // Horizon line
 
     // --- Draw Parallax Background ---
     for(int i=0; i<3; i++) {
-        int cloudX = (int)(i * 160 - camera.z * 0.005f) % (SCREEN_WIDTH + 100) - 50;
+        int cloudX = (int)(i * 160 - view.z * 0.005f) % (SCREEN_WIDTH + 100) - 50;
         canvas.fillCircle(cloudX, 25 + i*10, 15, COLOR_PRIMARY);
         canvas.fillCircle(cloudX + 10, 30 + i*10, 12, COLOR_PRIMARY);
     }
 
-    // Static distant mountains
+    // Static distant mountains (0.0002 rad per z unit = 0.004 px)
+    updateMountainProfile((int32_t)(view.z * 0.004f));
     for(int i=0; i<SCREEN_WIDTH; i++) {
-        float m1 = sin(i * 0.05f + camera.z * 0.0002f) * 15 + 20;
-        canvas.drawFastVLine(i, SCREEN_HEIGHT/2 - m1, m1, 0x2124);
+        canvas.drawFastVLine(i, racingMountains.top[i], racingMountains.height[i], 0x2124);
     }
+    PROF_LAP(PROF_RACE_BACKDROP);
 
     // --- Road Parameters ---
-    float camX = camera.x;
-    float camY = camera.y;
-    float camZ = camera.z;
+    float camX = view.x;
+    float camY = view.y;
+    float camZ = view.z;
 
     // Hyperbolic Projection Constants
     const float roadDepth = 2000.0f;
@@ -4916,17 +7665,13 @@ void drawRacingGame() {
     uint16_t* buffer = canvas.getBuffer();
     float x = 0, dx = 0;
 
-    // Pre-calculate track curvature accumulation up to camera position
-    float startX = 0;
-    int currentSeg = 0;
-    float currentSegZ = 0;
-    while(currentSegZ < camZ && currentSeg < totalSegments) {
-        startX += track[currentSeg].curvature * (min(camZ - currentSegZ, (float)track[currentSeg].length * SEGMENT_STEP_LENGTH) / SEGMENT_STEP_LENGTH);
-        currentSegZ += track[currentSeg].length * SEGMENT_STEP_LENGTH;
-        currentSeg++;
-    }
+    // Track curvature accumulated up to the camera position
+    int segIdx = trackSegmentAt(camZ);
+    float startX = trackCurveX(segIdx, camZ);
 
-    for (int y = SCREEN_HEIGHT - 1; y >= SCREEN_HEIGHT / 2; y--) {
+    // lineZ grows towards the horizon, so one cursor walks the segments
+    int roadStep = qualityRoadRowStep();
+    for (int y = SCREEN_HEIGHT - 1; y >= SCREEN_HEIGHT / 2; y -= roadStep) {
         // Perspective factor (0 at horizon, 1 at bottom)
         float p = (float)(y - SCREEN_HEIGHT/2) / (SCREEN_HEIGHT / 2.0f);
         if (p < 0.01f) p = 0.01f;
@@ -4934,17 +7679,9 @@ void drawRacingGame() {
         float lineZ = camZ + (1.0f / p) * 100.0f; // Hyperbolic projection
         float roadWidth = p * 400.0f;
 
-        // Find segment for this lineZ
-        int segIdx = 0;
-        float segZ = 0;
-        float segAccumX = 0;
-        while(segIdx < totalSegments - 1 && segZ + track[segIdx].length * SEGMENT_STEP_LENGTH < lineZ) {
-            segAccumX += track[segIdx].curvature * track[segIdx].length;
-            segZ += track[segIdx].length * SEGMENT_STEP_LENGTH;
-            segIdx++;
-        }
-        float relativeZ = (lineZ - segZ) / SEGMENT_STEP_LENGTH;
-        float currentX = segAccumX + track[segIdx].curvature * relativeZ;
+        // Advance to the segment for this lineZ
+        while (segIdx < totalSegments - 1 && trackStartZ[segIdx + 1] < lineZ) segIdx++;
+        float currentX = trackCurveX(segIdx, lineZ);
 
         float screenX = SCREEN_WIDTH/2 + (currentX - startX - camX/1000.0f) * roadWidth;
 
@@ -4972,12 +7709,18 @@ void drawRacingGame() {
                 row[i] = rumbleColor;
             }
         }
+        if (roadStep > 1 && y - 1 >= SCREEN_HEIGHT / 2) spanCopy565(row - SCREEN_WIDTH, row, SCREEN_WIDTH);
     }
+    PROF_LAP(PROF_RACE_ROAD);
 
     // --- Draw Scenery (Back-to-Front) ---
-    for(int i = sceneryCount - 1; i >= 0; i--) {
+    // Only the buckets of segments inside the draw distance
+    float drawDistance = qualityDrawDistance();
+    int nearScenery = sceneryFirst[trackSegmentAt(camZ + 100)];
+    int farScenery = sceneryFirst[min(trackSegmentAt(camZ + drawDistance) + 2, totalSegments)];
+    for(int i = farScenery - 1; i >= nearScenery; i--) {
         float dz = scenery[i].z - camZ;
-        if (dz < 100 || dz > 4000) continue;
+        if (dz < 100 || dz > drawDistance) continue;
 
         float p = 150.0f / dz;
         float screenX = SCREEN_WIDTH/2 + (scenery[i].x * 200.0f - camX/10.0f) * p * 100.0f;
@@ -4994,22 +7737,23 @@ void drawRacingGame() {
     }
 
     // --- Draw AI & Opponents ---
-    auto drawCar = [&](Car& c, uint16_t const* sprite) {
-        float dz = c.z - camZ;
-        if (dz < 0) dz += totalSegments * SEGMENT_STEP_LENGTH; // Handle wrap
-        if (dz > 100 && dz < 4000) {
+    auto drawCar = [&](const Car& prev, const Car& c, uint16_t const* sprite) {
+        float dz = simLerp(prev.z, c.z) - camZ;
+        if (dz < 0) dz += trackLengthZ(); // Handle wrap
+        if (dz > 100 && dz < drawDistance) {
             float p = 150.0f / dz;
-            float screenX = SCREEN_WIDTH/2 + (c.x * 200.0f - camX/10.0f) * p * 100.0f;
+            float screenX = SCREEN_WIDTH/2 + (simLerp(prev.x, c.x) * 200.0f - camX/10.0f) * p * 100.0f;
             float screenY = SCREEN_HEIGHT/2 + p * 200.0f;
             float scale = p * 15.0f;
             drawScaledColorBitmap(screenX - 16*scale, screenY - 16*scale, sprite, 32, 16, scale);
         }
     };
-    drawCar(aiCar, sprite_car_opponent);
-    if (opponentPresent) drawCar(opponentCar, sprite_car_opponent);
+    drawCar(aiCarPrev, aiCar, sprite_car_opponent);
+    if (opponentPresent) drawCar(opponentCarPrev, opponentCar, sprite_car_opponent);
 
     // --- Draw Player Car ---
     drawScaledColorBitmap(SCREEN_WIDTH/2 - 48, SCREEN_HEIGHT - 60, sprite_car_player, 32, 16, 3.0);
+    PROF_LAP(PROF_RACE_SPRITES);
 
     // --- HUD REDESIGN ---
     // Digital Speedometer (Bottom Left)
@@ -5032,8 +7776,7 @@ void drawRacingGame() {
     canvas.print(" km/h");
 
     // Track Progress (Top)
-    int totalLen = 0; for(int i=0; i<totalSegments; i++) totalLen += track[i].length * SEGMENT_STEP_LENGTH;
-    float prog = playerCar.z / (float)totalLen;
+    float prog = playerCar.z / (float)trackLengthZ();
     canvas.drawRect(50, 10, SCREEN_WIDTH - 100, 6, 0x4208);
     canvas.fillRect(50, 10, (SCREEN_WIDTH - 100) * prog, 6, COLOR_TEAL_SOFT);
 
@@ -5043,40 +7786,20 @@ void drawRacingGame() {
     canvas.print("LAP: "); canvas.print(playerCar.lap + 1);
     canvas.setCursor(SCREEN_WIDTH - 80, 18);
     canvas.print("BEST: "); canvas.print(sysConfig.racingBest);
+    PROF_LAP(PROF_RACE_HUD);
 
-    // Screen Shake
-    int sx = 0, sy = 0;
+    // Screen Shake (applied by pushCanvas() in refreshCurrentScreen)
     if (screenShake > 0) {
-        sx = random(-(int)screenShake, (int)screenShake + 1);
-        sy = random(-(int)screenShake, (int)screenShake + 1);
+        frameShakeX = rngRange(rngParticles, -(int)screenShake, (int)screenShake + 1);
+        frameShakeY = rngRange(rngParticles, -(int)screenShake, (int)screenShake + 1);
     }
-    tft.drawRGBBitmap(sx, sy, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void triggerPongParticles(float x, float y) {
-  for (int i = 0; i < MAX_PONG_PARTICLES; i++) {
-    if (pongParticles[i].life <= 0) {
-      pongParticles[i].x = x;
-      pongParticles[i].y = y;
-      pongParticles[i].vx = random(-100, 100) / 50.0f;
-      pongParticles[i].vy = random(-100, 100) / 50.0f;
-      pongParticles[i].life = 20; // Lifetime in frames
-      return; // Spawn one particle per collision
-    }
-  }
-}
-
-void updateAndDrawPongParticles() {
-  for (int i = 0; i < MAX_PONG_PARTICLES; i++) {
-    if (pongParticles[i].life > 0) {
-      pongParticles[i].x += pongParticles[i].vx;
-      pongParticles[i].y += pongParticles[i].vy;
-      pongParticles[i].life--;
-
-      int size = (pongParticles[i].life > 10) ? 2 : 1;
-      canvas.fillRect(pongParticles[i].x, pongParticles[i].y, size, size, COLOR_PRIMARY);
-    }
-  }
+  // One particle per collision, lifetime in steps; 2x2, then 1x1 for the last 10
+  float vx = rngFloat(rngParticles) * 4.0f - 2.0f;
+  float vy = rngFloat(rngParticles) * 4.0f - 2.0f;
+  particleSpawn(pongParticles, x, y, vx, vy, 20, COLOR_PRIMARY, 2);
 }
 
 // ============ PONG GAME LOGIC & DRAWING ============
@@ -5084,9 +7807,10 @@ void resetPongBall() {
   pongBall.x = SCREEN_WIDTH / 2;
   pongBall.y = SCREEN_HEIGHT / 2;
   // Give it a random horizontal direction
-  pongBall.vx = (random(0, 2) == 0 ? 1 : -1) * 150.0f;
+  pongBall.vx = (rngRange(rngGame, 0, 2) == 0 ? 1 : -1) * 150.0f;
   // Give it a slight random vertical direction
-  pongBall.vy = random(-50, 50);
+  pongBall.vy = rngRange(rngGame, -50, 50);
+  pongBallPrev = pongBall;
 }
 
 void updatePongLogic() {
@@ -5096,23 +7820,38 @@ void updatePongLogic() {
     player2.score = 0;
     player1.y = SCREEN_HEIGHT / 2 - 20;
     player2.y = SCREEN_HEIGHT / 2 - 20;
+    player1PrevY = player1.y;
+    player2PrevY = player2.y;
     resetPongBall();
     pongGameActive = true;
     pongRunning = false;
     lastLobbyPing = 0;
     // Clear particles
-    for(int i=0; i<MAX_PONG_PARTICLES; i++) pongParticles[i].life = 0;
+    particlesClear(pongParticles);
     return;
   }
 
   if (!pongRunning) {
+    if (gameButtonPressed(BTN_SELECT)) {
+      pongRunning = true;
+      ledSuccess();
+    }
     if (millis() - lastLobbyPing > 500) {
       lastLobbyPing = millis();
     }
     return;
   }
 
-  float dt = deltaTime; // Use global deltaTime
+  const float dt = SIM_DT;
+  pongBallPrev = pongBall;
+  player1PrevY = player1.y;
+  player2PrevY = player2.y;
+  particlesUpdate(pongParticles);
+
+  // Player paddle
+  float paddleSpeed = 250.0f * dt;
+  if (gameButton(BTN_UP)) player1.y = max(0.0f, player1.y - paddleSpeed);
+  if (gameButton(BTN_DOWN)) player1.y = min(SCREEN_HEIGHT - 40.0f, player1.y + paddleSpeed);
 
   // Ball movement
   pongBall.x += pongBall.vx * dt;
@@ -5187,7 +7926,7 @@ void drawPongGame() {
     canvas.drawFastVLine(SCREEN_WIDTH / 2, i, 5, COLOR_PANEL);
   }
 
-  updateAndDrawPongParticles();
+  particlesDraw(pongParticles);
 
   // Scores
   canvas.setTextSize(3);
@@ -5204,11 +7943,11 @@ void drawPongGame() {
   canvas.print("BEST: "); canvas.print(sysConfig.pongBest);
 
   // Paddles
-  canvas.fillRect(5, player1.y, PADDLE_WIDTH, PADDLE_HEIGHT, COLOR_PRIMARY);
-  canvas.fillRect(SCREEN_WIDTH - PADDLE_WIDTH - 5, player2.y, PADDLE_WIDTH, PADDLE_HEIGHT, COLOR_PRIMARY);
+  canvas.fillRect(5, simLerp(player1PrevY, player1.y), PADDLE_WIDTH, PADDLE_HEIGHT, COLOR_PRIMARY);
+  canvas.fillRect(SCREEN_WIDTH - PADDLE_WIDTH - 5, simLerp(player2PrevY, player2.y), PADDLE_WIDTH, PADDLE_HEIGHT, COLOR_PRIMARY);
 
   // Ball
-  canvas.fillRect(pongBall.x, pongBall.y, 10, 10, COLOR_PRIMARY);
+  canvas.fillRect(simLerp(pongBallPrev.x, pongBall.x), simLerp(pongBallPrev.y, pongBall.y), 10, 10, COLOR_PRIMARY);
 
   canvas.setTextColor(COLOR_DIM);
   canvas.setTextSize(1);
@@ -5221,13 +7960,11 @@ void drawPongGame() {
       canvas.setCursor(75, 78);
       canvas.print("Press SELECT");
   }
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 // ============ SNAKE GAME LOGIC ============
 void initSnakeGame() {
-  for (int i = 0; i < MAX_SNAKE_PARTICLES; i++) snakeParticles[i].life = 0;
+  particlesClear(snakeParticles);
   snakeLength = 3;
   snakeBody[0] = {SNAKE_GRID_WIDTH / 2, SNAKE_GRID_HEIGHT / 2};
   snakeBody[1] = {SNAKE_GRID_WIDTH / 2 - 1, SNAKE_GRID_HEIGHT / 2};
@@ -5240,8 +7977,8 @@ void initSnakeGame() {
   bool foodOnSnake;
   do {
     foodOnSnake = false;
-    food.x = random(0, SNAKE_GRID_WIDTH);
-    food.y = random(0, SNAKE_GRID_HEIGHT);
+    food.x = rngRange(rngGame, 0, SNAKE_GRID_WIDTH);
+    food.y = rngRange(rngGame, 0, SNAKE_GRID_HEIGHT);
     for (int i = 0; i < snakeLength; i++) {
       if (snakeBody[i].x == food.x && snakeBody[i].y == food.y) {
         foodOnSnake = true;
@@ -5250,22 +7987,29 @@ void initSnakeGame() {
     }
   } while (foodOnSnake);
 
-  lastSnakeUpdate = 0;
+  snakeMoveUs = 0;
 }
 
 void updateSnakeLogic() {
   if (snakeGameOver) {
-    if (digitalRead(BTN_SELECT) == BTN_ACT) {
+    if (gameButton(BTN_SELECT)) {
       initSnakeGame();
     }
     return;
   }
 
-  int snakeDelay = max(40, 100 - (snakeScore / 20) * 5);
-  if (millis() - lastSnakeUpdate < snakeDelay) { // Dynamic speed
+  // Steering
+  if (gameButton(BTN_UP) && snakeDir != SNAKE_DOWN) snakeDir = SNAKE_UP;
+  if (gameButton(BTN_DOWN) && snakeDir != SNAKE_UP) snakeDir = SNAKE_DOWN;
+  if (gameButton(BTN_LEFT) && snakeDir != SNAKE_RIGHT) snakeDir = SNAKE_LEFT;
+  if (gameButton(BTN_RIGHT) && snakeDir != SNAKE_LEFT) snakeDir = SNAKE_RIGHT;
+
+  uint32_t snakeDelayUs = max(40, 100 - (snakeScore / 20) * 5) * 1000UL; // Dynamic speed
+  snakeMoveUs += SIM_STEP_US;
+  if (snakeMoveUs < snakeDelayUs) {
     return;
   }
-  lastSnakeUpdate = millis();
+  snakeMoveUs -= snakeDelayUs;
 
   // Move body
   for (int i = snakeLength - 1; i > 0; i--) {
@@ -5285,13 +8029,7 @@ void updateSnakeLogic() {
   else if (snakeBody[0].y >= SNAKE_GRID_HEIGHT) snakeBody[0].y = 0;
 
   // Update particles
-  for (int i = 0; i < MAX_SNAKE_PARTICLES; i++) {
-    if (snakeParticles[i].life > 0) {
-      snakeParticles[i].x += snakeParticles[i].vx;
-      snakeParticles[i].y += snakeParticles[i].vy;
-      snakeParticles[i].life--;
-    }
-  }
+  particlesUpdate(snakeParticles);
 
   // Self collision
   for (int i = 1; i < snakeLength; i++) {
@@ -5308,14 +8046,15 @@ void updateSnakeLogic() {
   // Food collision
   if (snakeBody[0].x == food.x && snakeBody[0].y == food.y) {
     if (isDFPlayerAvailable) myDFPlayer.play(95);
-    // Particle burst
+    // Particle burst, replacing any previous one
+    particlesClear(snakeParticles);
     for (int i = 0; i < MAX_SNAKE_PARTICLES; i++) {
-      snakeParticles[i].x = food.x * SNAKE_GRID_SIZE + SNAKE_GRID_SIZE / 2;
-      snakeParticles[i].y = food.y * SNAKE_GRID_SIZE + SNAKE_GRID_SIZE / 2;
-      snakeParticles[i].vx = random(-30, 31) / 10.0f;
-      snakeParticles[i].vy = random(-30, 31) / 10.0f;
-      snakeParticles[i].life = random(10, 20);
-      snakeParticles[i].color = (random(0, 2) == 0) ? COLOR_ERROR : COLOR_WARN;
+      float vx = rngRange(rngParticles, -30, 31) / 10.0f;
+      float vy = rngRange(rngParticles, -30, 31) / 10.0f;
+      uint16_t life = rngRange(rngParticles, 10, 20);
+      uint16_t color = (rngRange(rngParticles, 0, 2) == 0) ? COLOR_ERROR : COLOR_WARN;
+      particleSpawn(snakeParticles, food.x * SNAKE_GRID_SIZE + SNAKE_GRID_SIZE / 2,
+                    food.y * SNAKE_GRID_SIZE + SNAKE_GRID_SIZE / 2, vx, vy, life, color, 1);
     }
     snakeScore += 10;
     if (snakeLength < MAX_SNAKE_LENGTH) {
@@ -5325,8 +8064,8 @@ void updateSnakeLogic() {
     bool foodOnSnake;
     do {
       foodOnSnake = false;
-      food.x = random(0, SNAKE_GRID_WIDTH);
-      food.y = random(0, SNAKE_GRID_HEIGHT);
+      food.x = rngRange(rngGame, 0, SNAKE_GRID_WIDTH);
+      food.y = rngRange(rngGame, 0, SNAKE_GRID_HEIGHT);
       for (int i = 0; i < snakeLength; i++) {
         if (snakeBody[i].x == food.x && snakeBody[i].y == food.y) {
           foodOnSnake = true;
@@ -5341,13 +8080,15 @@ void updateSnakeLogic() {
 // ============ FLAPPY ESP GAME LOGIC ============
 void initFlappyGame() {
   flappyBird.y = SCREEN_HEIGHT / 2;
+  flappyBirdPrevY = flappyBird.y;
   flappyBird.vy = 0;
   flappyBird.score = 0;
   flappyGameActive = true;
 
   for (int i = 0; i < FLAPPY_MAX_PIPES; i++) {
     flappyPipes[i].x = SCREEN_WIDTH + 50 + i * 120;
-    flappyPipes[i].gapY = random(20, SCREEN_HEIGHT - 85);
+    flappyPipePrevX[i] = flappyPipes[i].x;
+    flappyPipes[i].gapY = rngRange(rngGame, 20, SCREEN_HEIGHT - 85);
     flappyPipes[i].active = true;
     flappyPipes[i].passed = false;
   }
@@ -5355,25 +8096,23 @@ void initFlappyGame() {
 
 void updateFlappyLogic() {
   if (!flappyGameActive) {
-    if (digitalRead(BTN_SELECT) == BTN_ACT) {
+    if (gameButton(BTN_SELECT)) {
       initFlappyGame();
     }
     return;
   }
 
-  float dt = deltaTime;
+  const float dt = SIM_DT;
   const float gravity = 450.0f;
+  flappyBirdPrevY = flappyBird.y;
   const float pipeSpeed = 120.0f;
   const int pipeGap = 65;
   const int pipeWidth = 35;
 
   // Handle Input
-  static bool lastSelect = false;
-  bool currentSelect = (digitalRead(BTN_SELECT) == BTN_ACT);
-  if (currentSelect && !lastSelect) {
+  if (gameButtonPressed(BTN_SELECT)) {
     flappyBird.vy = -180.0f;
   }
-  lastSelect = currentSelect;
 
   flappyBird.vy += gravity * dt;
   flappyBird.y += flappyBird.vy * dt;
@@ -5388,6 +8127,7 @@ void updateFlappyLogic() {
   }
 
   for (int i = 0; i < FLAPPY_MAX_PIPES; i++) {
+    flappyPipePrevX[i] = flappyPipes[i].x;
     flappyPipes[i].x -= pipeSpeed * dt;
 
     if (flappyPipes[i].x < -pipeWidth) {
@@ -5396,7 +8136,8 @@ void updateFlappyLogic() {
         if (flappyPipes[j].x > maxX) maxX = flappyPipes[j].x;
       }
       flappyPipes[i].x = maxX + 120;
-      flappyPipes[i].gapY = random(20, SCREEN_HEIGHT - pipeGap - 20);
+      flappyPipePrevX[i] = flappyPipes[i].x; // Don't blend the jump back to the right
+      flappyPipes[i].gapY = rngRange(rngGame, 20, SCREEN_HEIGHT - pipeGap - 20);
       flappyPipes[i].passed = false;
     }
 
@@ -5426,14 +8167,16 @@ void drawFlappyGame() {
   for (int i = 0; i < FLAPPY_MAX_PIPES; i++) {
     int pipeWidth = 35;
     int pipeGap = 65;
-    canvas.fillRect(flappyPipes[i].x, 15, pipeWidth, flappyPipes[i].gapY - 15, COLOR_SUCCESS);
-    canvas.drawRect(flappyPipes[i].x, 15, pipeWidth, flappyPipes[i].gapY - 15, COLOR_BORDER);
-    canvas.fillRect(flappyPipes[i].x, flappyPipes[i].gapY + pipeGap, pipeWidth, SCREEN_HEIGHT - (flappyPipes[i].gapY + pipeGap), COLOR_SUCCESS);
-    canvas.drawRect(flappyPipes[i].x, flappyPipes[i].gapY + pipeGap, pipeWidth, SCREEN_HEIGHT - (flappyPipes[i].gapY + pipeGap), COLOR_BORDER);
+    float pipeX = simLerp(flappyPipePrevX[i], flappyPipes[i].x);
+    canvas.fillRect(pipeX, 15, pipeWidth, flappyPipes[i].gapY - 15, COLOR_SUCCESS);
+    canvas.drawRect(pipeX, 15, pipeWidth, flappyPipes[i].gapY - 15, COLOR_BORDER);
+    canvas.fillRect(pipeX, flappyPipes[i].gapY + pipeGap, pipeWidth, SCREEN_HEIGHT - (flappyPipes[i].gapY + pipeGap), COLOR_SUCCESS);
+    canvas.drawRect(pipeX, flappyPipes[i].gapY + pipeGap, pipeWidth, SCREEN_HEIGHT - (flappyPipes[i].gapY + pipeGap), COLOR_BORDER);
   }
 
-  canvas.fillRect(50, flappyBird.y, 14, 10, COLOR_WARN);
-  canvas.fillRect(58, flappyBird.y + 2, 3, 3, COLOR_BG);
+  float birdY = simLerp(flappyBirdPrevY, flappyBird.y);
+  canvas.fillRect(50, birdY, 14, 10, COLOR_WARN);
+  canvas.fillRect(58, birdY + 2, 3, 3, COLOR_BG);
 
   canvas.setTextSize(2);
   canvas.setTextColor(COLOR_PRIMARY);
@@ -5458,17 +8201,17 @@ void drawFlappyGame() {
     canvas.setCursor(SCREEN_WIDTH/2 - w/2, SCREEN_HEIGHT/2 + 10);
     canvas.print("SELECT to Restart");
   }
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 // ============ BREAKOUT GAME LOGIC ============
 void initBreakoutGame() {
   breakoutBall.x = SCREEN_WIDTH / 2;
   breakoutBall.y = SCREEN_HEIGHT - 60;
-  breakoutBall.vx = (random(0, 2) == 0 ? 1 : -1) * 120.0f;
+  breakoutBall.vx = (rngRange(rngGame, 0, 2) == 0 ? 1 : -1) * 120.0f;
   breakoutBall.vy = -120.0f;
   breakoutPaddle.x = SCREEN_WIDTH / 2 - 25;
+  breakoutBallPrev = breakoutBall;
+  breakoutPaddlePrevX = breakoutPaddle.x;
   breakoutScore = 0;
   breakoutGameActive = true;
   uint16_t rowColors[] = {COLOR_ERROR, 0xFD20, COLOR_WARN, COLOR_SUCCESS, 0x001F};
@@ -5482,17 +8225,19 @@ void initBreakoutGame() {
 
 void updateBreakoutLogic() {
   if (!breakoutGameActive) {
-    if (digitalRead(BTN_SELECT) == BTN_ACT) initBreakoutGame();
+    if (gameButton(BTN_SELECT)) initBreakoutGame();
     return;
   }
-  float dt = deltaTime;
+  const float dt = SIM_DT;
   const int ballRadius = 3;
+  breakoutBallPrev = breakoutBall;
+  breakoutPaddlePrevX = breakoutPaddle.x;
   const int paddleW = 50;
   const float paddleSpeed = 200.0f;
 
   // Handle Input
-  if (digitalRead(BTN_LEFT) == BTN_ACT) breakoutPaddle.x -= paddleSpeed * dt;
-  if (digitalRead(BTN_RIGHT) == BTN_ACT) breakoutPaddle.x += paddleSpeed * dt;
+  if (gameButton(BTN_LEFT)) breakoutPaddle.x -= paddleSpeed * dt;
+  if (gameButton(BTN_RIGHT)) breakoutPaddle.x += paddleSpeed * dt;
   breakoutPaddle.x = constrain(breakoutPaddle.x, 0, SCREEN_WIDTH - paddleW);
 
   breakoutBall.x += breakoutBall.vx * dt;
@@ -5540,8 +8285,8 @@ void drawBreakoutGame() {
   drawStatusBar();
   int paddleW = 50;
   int paddleH = 6;
-  canvas.fillRect(breakoutPaddle.x, SCREEN_HEIGHT - 20, paddleW, paddleH, COLOR_PRIMARY);
-  canvas.fillCircle(breakoutBall.x, breakoutBall.y, 3, COLOR_PRIMARY);
+  canvas.fillRect(simLerp(breakoutPaddlePrevX, breakoutPaddle.x), SCREEN_HEIGHT - 20, paddleW, paddleH, COLOR_PRIMARY);
+  canvas.fillCircle(simLerp(breakoutBallPrev.x, breakoutBall.x), simLerp(breakoutBallPrev.y, breakoutBall.y), 3, COLOR_PRIMARY);
   int brickAreaY = 40;
   for (int r = 0; r < BREAKOUT_ROWS; r++) {
     for (int c = 0; c < BREAKOUT_COLS; c++) {
@@ -5572,7 +8317,6 @@ void drawBreakoutGame() {
     canvas.setCursor(SCREEN_WIDTH/2 - w/2, SCREEN_HEIGHT/2 + 10);
     canvas.print("SELECT to Restart");
   }
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 // ============ VIRTUAL PET LOGIC & DRAWING ============
@@ -5742,8 +8486,6 @@ void drawPetGame() {
     canvas.setCursor(x + (itemW - txtW) / 2, menuY + 8);
     canvas.print(items[i]);
   }
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawESPNowMenu() {
@@ -5814,8 +8556,6 @@ void drawESPNowMenu() {
        canvas.print(menuItems[i]);
     }
   }
-  
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawESPNowPeerList() {
@@ -5874,8 +8614,6 @@ void drawESPNowPeerList() {
   canvas.setTextColor(COLOR_DIM);
   canvas.setTextSize(1);
   canvas.setCursor(10, SCREEN_HEIGHT - 12);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 // ============ HACKER TOOLS: SNIFFER, NETSCAN, FILES ============
@@ -5930,8 +8668,6 @@ void drawSniffer() {
 
   canvas.setCursor(10, SCREEN_HEIGHT - 12);
   canvas.print("Scanning...");
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawNetScan() {
@@ -5948,7 +8684,6 @@ void drawNetScan() {
     canvas.setTextColor(COLOR_ERROR);
     canvas.setCursor(10, 50);
     canvas.print("WiFi Disconnected!");
-    tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
     return;
   }
 
@@ -5985,8 +8720,6 @@ void drawNetScan() {
   canvas.setTextColor(COLOR_DIM);
   canvas.setCursor(10, SCREEN_HEIGHT - 12);
   canvas.print("Scanning...");
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawFileManager() {
@@ -6003,7 +8736,6 @@ void drawFileManager() {
     canvas.setTextColor(COLOR_ERROR);
     canvas.setCursor(10, 50);
     canvas.print("SD Card Not Found!");
-    tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
     return;
   }
 
@@ -6059,8 +8791,6 @@ void drawFileManager() {
   }
 
   canvas.setTextColor(COLOR_DIM);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawAboutScreen() {
@@ -6103,8 +8833,6 @@ void drawAboutScreen() {
   // Footer
   canvas.setTextColor(COLOR_DIM);
   canvas.setCursor(10, SCREEN_HEIGHT - 12);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawWiFiSonar() {
@@ -6143,7 +8871,6 @@ void drawWiFiSonar() {
     canvas.setTextColor(COLOR_ERROR);
     canvas.setCursor(10, 50);
     canvas.print("Connect WiFi first!");
-    tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
     return;
   }
 
@@ -6161,8 +8888,6 @@ void drawWiFiSonar() {
   canvas.print("Target: "); canvas.print(WiFi.SSID());
   canvas.setCursor(10, SCREEN_HEIGHT - 12);
   canvas.print("RSSI Delta Graph");
-  
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 ConversationContext extractEnhancedContext() {
@@ -6915,11 +9640,14 @@ void updateBatteryLevel() {
 void updateStatusBarData() {
   if (millis() - lastStatusBarUpdate > 1000) {
     lastStatusBarUpdate = millis();
-    if (WiFi.status() == WL_CONNECTED) {
+    cachedWifiConnected = (WiFi.status() == WL_CONNECTED);
+    if (cachedWifiConnected) {
        cachedRSSI = WiFi.RSSI();
     } else {
        cachedRSSI = 0;
     }
+    String prevTime = cachedTimeStr;
+    int prevBattery = batteryPercentage;
     struct tm timeinfo;
     if (getLocalTime(&timeinfo, 0)) {
        char timeStringBuff[10];
@@ -6927,18 +9655,21 @@ void updateStatusBarData() {
        cachedTimeStr = String(timeStringBuff);
     }
     updateBatteryLevel();
+    if (cachedTimeStr != prevTime || batteryPercentage != prevBattery) {
+      invalidateScreen(INVAL_DATA);
+    }
   }
 }
 
-void drawBatteryIcon() {
+void drawBatteryIcon(GFXcanvas16& g) {
     int x = SCREEN_WIDTH - 25;
     int y = 2;
     int w = 22;
     int h = 10;
 
     // Draw icon box first
-    canvas.drawRect(x, y, w, h, COLOR_DIM);
-    canvas.fillRect(x + w, y + 2, 2, h - 4, COLOR_DIM);
+    g.drawRect(x, y, w, h, COLOR_DIM);
+    g.fillRect(x + w, y + 2, 2, h - 4, COLOR_DIM);
 
     if (batteryPercentage == -1) return;
 
@@ -6953,134 +9684,302 @@ void drawBatteryIcon() {
     // Draw the fill level inside the icon
     int fillW = map(batteryPercentage, 0, 100, 0, w - 2);
     if (fillW > 0) {
-      canvas.fillRect(x + 1, y + 1, fillW, h - 2, battColor);
+      g.fillRect(x + 1, y + 1, fillW, h - 2, battColor);
     }
 
     // Draw percentage text to the left of the icon
-    canvas.setTextSize(1);
-    canvas.setTextColor(battColor);
-    char buf[10];
-    sprintf(buf, "%.1fV %d%%", batteryVoltage, batteryPercentage);
-    String text(buf);
-    int16_t x1, y1;
-    uint16_t textW, textH;
-    canvas.getTextBounds(text, 0, 0, &x1, &y1, &textW, &textH);
+    g.setTextSize(1);
+    g.setTextColor(battColor);
+    char buf[16];
+    int len = snprintf(buf, sizeof(buf), "%.1fV %d%%", batteryVoltage, batteryPercentage);
     // Position text with a 5px gap to the left of the icon
-    canvas.setCursor(x - textW - 5, y + 2);
-    canvas.print(text);
-}
+    g.setCursor(x - (len * 6 - 1) - 5, y + 2);
+    g.print(buf);
+}
+
+// ============ STATUS BAR LAYER ============
+// The status bar is rendered into its own 320x16 canvas only when one of its
+// inputs changes. Pixels left at STATUS_BAR_KEY are see-through: they become
+// the dimmed backdrop (COLOR_BG blended at 180) and everything else is
+// recorded as opaque runs. Compositing is a memcpy of the baked layer when the
+// canvas under the bar is plain COLOR_BG, and blend + run copy otherwise.
+#define STATUS_BAR_HEIGHT 16
+#define STATUS_BAR_BLEND_ROWS 15
+#define STATUS_BAR_KEY 0x0020       // never used by the UI palette
+#define STATUS_BAR_MAX_RUNS 384
+
+GFXcanvas16 statusCanvas(SCREEN_WIDTH, STATUS_BAR_HEIGHT);
+
+struct StatusRun {
+  uint8_t y;
+  uint16_t x, len;
+};
+StatusRun statusRuns[STATUS_BAR_MAX_RUNS];
+int statusRunCount = 0;
+bool statusRunsOverflow = false;
+bool statusBlendBackdrop = true;   // false while the alert banner is shown
+
+// Everything the bar shows; compared with memcmp, so built from a zeroed struct
+struct StatusBarKey {
+  char time[8];
+  uint8_t alert;        // 0 = none, 1 = banner phase, 2 = normal phase of an alert
+  bool sd, espnow, wifi, fps, prayer, quake;
+  int16_t chat, peers, prayerMinutes;
+  int16_t batteryPct, batteryDeciVolts;
+  int8_t wifiBars;
+  int16_t fpsValue, pushK;
+};
+StatusBarKey statusKey;
+bool statusLayerValid = false;
 
+// Prayer countdown and quake flag only change on a minute boundary or when
+// their data changes, so getNextPrayer() runs at most once per minute
+int statusPrayerMinutes = 0;
+bool statusQuakeShown = false;
 
-void drawStatusBar() {
+void updateStatusSlowInputs(StatusBarKey& k) {
+  static uint32_t lastStamp = 0xFFFFFFFF;
+  uint32_t stamp = (millis() / 60000) * 31 + textLayoutHash(cachedTimeStr);
+  stamp = stamp * 31 + (currentPrayer.isValid ? 1 : 0) + (currentState == STATE_PRAYER_TIMES ? 2 : 0);
+  stamp = stamp * 31 + earthquakeCount + (earthquakeDataLoaded ? 1000 : 0);
+  if (earthquakeCount > 0) stamp = stamp * 31 + (uint32_t)earthquakes[0].time;
+
+  if (stamp != lastStamp) {
+    lastStamp = stamp;
+    if (currentPrayer.isValid && currentState != STATE_PRAYER_TIMES) {
+      statusPrayerMinutes = getNextPrayer().remainingMinutes;
+    }
+    statusQuakeShown = false;
+    if (earthquakeCount > 0 && earthquakes[0].magnitude >= 5.0 && earthquakeDataLoaded) {
+      time_t now_t; time(&now_t);
+      uint64_t currentMs = (now_t > 1000000000) ? (uint64_t)now_t * 1000 : (uint64_t)millis();
+      statusQuakeShown = currentMs - earthquakes[0].time < 3600000;
+    }
+  }
+  k.prayer = currentPrayer.isValid && currentState != STATE_PRAYER_TIMES;
+  k.prayerMinutes = k.prayer ? statusPrayerMinutes : 0;
+  k.quake = statusQuakeShown;
+}
+
+void buildStatusBarKey(StatusBarKey& k) {
+  memset(&k, 0, sizeof(k));
   if (emergencyActive) {
     if (millis() > emergencyEnd) {
       emergencyActive = false;
     } else {
-      if ((millis() / 500) % 2 == 0) {
-        canvas.fillRect(0, 0, SCREEN_WIDTH, 13, COLOR_ERROR);
-        canvas.setTextColor(COLOR_PRIMARY);
-        canvas.setTextSize(1);
-        int16_t x1, y1; uint16_t w, h;
-        canvas.getTextBounds("!! EMERGENCY ALERT !!", 0, 0, &x1, &y1, &w, &h);
-        canvas.setCursor((SCREEN_WIDTH - w) / 2, 3);
-        canvas.print("!! EMERGENCY ALERT !!");
-        return;
-      }
+      k.alert = ((millis() / 500) % 2 == 0) ? 1 : 2;
     }
   }
+  if (k.alert == 1) return;  // banner hides everything else
 
-  fillRectAlpha(0, 0, SCREEN_WIDTH, 15, COLOR_BG, 180);
-  canvas.drawFastHLine(0, 15, SCREEN_WIDTH, COLOR_VAPOR_CYAN);
+  strncpy(k.time, cachedTimeStr.c_str(), sizeof(k.time) - 1);
+  k.sd = sdCardMounted;
+  k.chat = chatMessageCount;
+  k.espnow = espnowInitialized;
+  k.peers = espnowInitialized ? espnowPeerCount : 0;
+  updateStatusSlowInputs(k);
+  k.fps = showFPS;
+  if (showFPS) {
+    k.fpsValue = perfFPS;
+    k.pushK = (perfBytesPerFrame + 512) / 1024;
+  }
+  k.batteryPct = batteryPercentage;
+  k.batteryDeciVolts = (int16_t)(batteryVoltage * 10.0f + 0.5f);
+  k.wifi = cachedWifiConnected;
+  if (k.wifi) {
+    if (cachedRSSI > -55) k.wifiBars = 4;
+    else if (cachedRSSI > -65) k.wifiBars = 3;
+    else if (cachedRSSI > -75) k.wifiBars = 2;
+    else if (cachedRSSI > -85) k.wifiBars = 1;
+  }
+}
+
+void renderStatusBarLayer(const StatusBarKey& k) {
+  GFXcanvas16& g = statusCanvas;
+  g.fillScreen(STATUS_BAR_KEY);
+  g.setTextWrap(false);
+  g.setTextSize(1);
+
+  if (k.alert == 1) {
+    g.fillRect(0, 0, SCREEN_WIDTH, 13, COLOR_ERROR);
+    g.setTextColor(COLOR_PRIMARY);
+    // "!! EMERGENCY ALERT !!" is 21 chars of 6px
+    g.setCursor((SCREEN_WIDTH - (21 * 6 - 1)) / 2, 3);
+    g.print("!! EMERGENCY ALERT !!");
+    return;
+  }
 
-  int prayerWidth = 0;
-  canvas.setTextColor(COLOR_PRIMARY);
-  canvas.setTextSize(1);
+  g.drawFastHLine(0, 15, SCREEN_WIDTH, COLOR_VAPOR_CYAN);
 
-  if (cachedTimeStr.length() > 0) {
-    canvas.setTextColor(COLOR_VAPOR_CYAN);
-    canvas.setCursor(5, 4);
-    canvas.print(cachedTimeStr);
+  int prayerWidth = 0;
+  if (k.time[0] != '\0') {
+    g.setTextColor(COLOR_VAPOR_CYAN);
+    g.setCursor(5, 4);
+    g.print(k.time);
   }
-  
+
   int iconX = 50;
-  if (sdCardMounted) {
-    canvas.fillRoundRect(iconX, 2, 20, 10, 2, COLOR_SUCCESS);
-    canvas.setTextColor(COLOR_BG);
-    canvas.setCursor(iconX + 4, 3);
-    canvas.print("SD");
+  if (k.sd) {
+    g.fillRoundRect(iconX, 2, 20, 10, 2, COLOR_SUCCESS);
+    g.setTextColor(COLOR_BG);
+    g.setCursor(iconX + 4, 3);
+    g.print("SD");
     iconX += 25;
   }
-  
-  if (chatMessageCount > 0) {
-    canvas.fillRoundRect(iconX, 2, 20, 10, 2, COLOR_VAPOR_PINK);
-    canvas.setTextColor(COLOR_BG);
-    canvas.setCursor(iconX + 4, 3);
-    canvas.print(chatMessageCount);
+
+  if (k.chat > 0) {
+    g.fillRoundRect(iconX, 2, 20, 10, 2, COLOR_VAPOR_PINK);
+    g.setTextColor(COLOR_BG);
+    g.setCursor(iconX + 4, 3);
+    g.print(k.chat);
     iconX += 25;
   }
-  
-  if (espnowInitialized) {
-    canvas.setTextColor(COLOR_VAPOR_PURPLE);
-    canvas.setCursor(iconX, 4);
-    canvas.print("E:");
-    canvas.print(espnowPeerCount);
+
+  if (k.espnow) {
+    g.setTextColor(COLOR_VAPOR_PURPLE);
+    g.setCursor(iconX, 4);
+    g.print("E:");
+    g.print(k.peers);
     iconX += 35;
   }
 
-  if (currentPrayer.isValid && currentState != STATE_PRAYER_TIMES) {
-    NextPrayerInfo next = getNextPrayer();
-    String countdown = formatRemainingTime(next.remainingMinutes);
+  if (k.prayer) {
+    String countdown = formatRemainingTime(k.prayerMinutes);
     prayerWidth = (countdown.length() + 2) * 6;
-    canvas.setCursor(SCREEN_WIDTH - 115 - prayerWidth, 4);
-    canvas.setTextColor(COLOR_SUCCESS);
-    canvas.print("P:");
-    canvas.print(countdown);
+    g.setCursor(SCREEN_WIDTH - 115 - prayerWidth, 4);
+    g.setTextColor(COLOR_SUCCESS);
+    g.print("P:");
+    g.print(countdown);
   }
 
-  if (earthquakeCount > 0 && earthquakes[0].magnitude >= 5.0) {
-    time_t now_t; time(&now_t);
-    uint64_t currentMs = (now_t > 1000000000) ? (uint64_t)now_t * 1000 : (uint64_t)millis();
-    if (earthquakeDataLoaded && (currentMs - earthquakes[0].time < 3600000)) {
-        canvas.setTextColor(COLOR_ERROR);
-        int eqX = SCREEN_WIDTH - 130 - prayerWidth - (showFPS ? 60 : 0);
-        canvas.setCursor(eqX, 4);
-        canvas.print("EQ!");
-    }
+  if (k.quake) {
+    g.setTextColor(COLOR_ERROR);
+    g.setCursor(SCREEN_WIDTH - 130 - prayerWidth - (k.fps ? 96 : 0), 4);
+    g.print("EQ!");
   }
 
-  if (showFPS) {
+  if (k.fps) {
     uint16_t fpsColor = COLOR_SUCCESS;
-    if (perfFPS < 100) fpsColor = COLOR_WARN;
-    if (perfFPS < 60) fpsColor = COLOR_ERROR;
-    String fpsStr = String(perfFPS);
-    int textWidth = (fpsStr.length() + 4) * 6;
-    int panelX = SCREEN_WIDTH - 120 - prayerWidth - textWidth;
-    canvas.setTextColor(fpsColor);
-    canvas.setCursor(panelX, 4);
-    canvas.print(fpsStr);
-    canvas.setTextColor(COLOR_DIM);
-    canvas.print(" FPS");
-  }
-
-  drawBatteryIcon();
-
-  if (WiFi.status() == WL_CONNECTED) {
-    int bars = 0;
-    if (cachedRSSI > -55) bars = 4;
-    else if (cachedRSSI > -65) bars = 3;
-    else if (cachedRSSI > -75) bars = 2;
-    else if (cachedRSSI > -85) bars = 1;
+    if (k.fpsValue < 100) fpsColor = COLOR_WARN;
+    if (k.fpsValue < 60) fpsColor = COLOR_ERROR;
+    char fpsStr[8], pushStr[8];
+    int fpsLen = snprintf(fpsStr, sizeof(fpsStr), "%d", k.fpsValue);
+    int pushLen = snprintf(pushStr, sizeof(pushStr), "%dK", k.pushK);
+    int panelX = SCREEN_WIDTH - 120 - prayerWidth - (fpsLen + 5 + pushLen) * 6;
+    g.setTextColor(fpsColor);
+    g.setCursor(panelX, 4);
+    g.print(fpsStr);
+    g.setTextColor(COLOR_DIM);
+    g.print(" FPS ");
+    g.print(pushStr);
+  }
+
+  drawBatteryIcon(g);
+
+  if (k.wifi) {
     int x = SCREEN_WIDTH - 105;
     int y = 10;
     for (int i = 0; i < 4; i++) {
       int h = (i + 1) * 2;
-      canvas.fillRect(x + (i * 3), y - h, 2, h, (i < bars) ? COLOR_VAPOR_CYAN : COLOR_PANEL);
+      g.fillRect(x + (i * 3), y - h, 2, h, (i < k.wifiBars) ? COLOR_VAPOR_CYAN : COLOR_PANEL);
     }
   } else {
-    canvas.setCursor(SCREEN_WIDTH - 105, 4);
-    canvas.setTextColor(COLOR_ERROR);
-    canvas.print("OFF");
+    g.setCursor(SCREEN_WIDTH - 105, 4);
+    g.setTextColor(COLOR_ERROR);
+    g.print("OFF");
+  }
+}
+
+// Record the opaque runs of the freshly rendered layer and bake the
+// see-through pixels to the dimmed backdrop. If the runs don't fit, the layer
+// keeps its key pixels and drawStatusBar falls back to a per-pixel copy.
+void bakeStatusBarLayer() {
+  uint16_t* lay = statusCanvas.getBuffer();
+
+  statusRunCount = 0;
+  statusRunsOverflow = false;
+  for (int y = 0; y < STATUS_BAR_HEIGHT && !statusRunsOverflow; y++) {
+    const uint16_t* row = lay + y * SCREEN_WIDTH;
+    int x = 0;
+    while (x < SCREEN_WIDTH) {
+      if (row[x] == STATUS_BAR_KEY) { x++; continue; }
+      int start = x;
+      while (x < SCREEN_WIDTH && row[x] != STATUS_BAR_KEY) x++;
+      if (statusRunCount == STATUS_BAR_MAX_RUNS) {
+        statusRunsOverflow = true;
+        break;
+      }
+      statusRuns[statusRunCount++] = {(uint8_t)y, (uint16_t)start, (uint16_t)(x - start)};
+    }
   }
+  if (statusRunsOverflow || !statusBlendBackdrop) return;
+
+  uint16_t backdrop = COLOR_BG;
+  spanBlend565(&backdrop, 1, COLOR_BG, 180);
+  for (int i = 0; i < STATUS_BAR_BLEND_ROWS * SCREEN_WIDTH; i++) {
+    if (lay[i] == STATUS_BAR_KEY) lay[i] = backdrop;
+  }
+}
+
+// True if n pixels from p are all `color` (p is 4-byte aligned, n even)
+bool spanIsUniform565(const uint16_t* p, int n, uint16_t color) {
+  const uint32_t pair = ((uint32_t)color << 16) | color;
+  const uint32_t* w = (const uint32_t*)p;
+  for (int i = 0; i < n / 2; i++) {
+    if (w[i] != pair) return false;
+  }
+  return true;
+}
+
+void drawStatusBar() {
+  PROF_SCOPE(PROF_STATUS_BAR);
+  StatusBarKey k;
+  buildStatusBarKey(k);
+  bool alertBanner = (k.alert == 1);
+  if (!statusLayerValid || memcmp(&k, &statusKey, sizeof(k)) != 0) {
+    statusKey = k;
+    statusBlendBackdrop = !alertBanner;
+    renderStatusBarLayer(k);
+    bakeStatusBarLayer();
+    statusLayerValid = true;
+  }
+
+  uint16_t* dst = canvas.getBuffer();
+  const uint16_t* lay = statusCanvas.getBuffer();
+  int blendRows = statusBlendBackdrop ? STATUS_BAR_BLEND_ROWS : 0;
+
+  // Backdrop rows: plain COLOR_BG underneath means the baked row is exact
+  int y = 0;
+  if (!statusRunsOverflow) {
+    for (; y < blendRows; y++) {
+      uint16_t* row = dst + y * SCREEN_WIDTH;
+      if (!spanIsUniform565(row, SCREEN_WIDTH, COLOR_BG)) break;
+    }
+    if (y == blendRows && y > 0) {
+      memcpy(dst, lay, blendRows * SCREEN_WIDTH * sizeof(uint16_t));
+    } else {
+      y = 0;
+    }
+  }
+  for (int j = y; j < blendRows; j++) {
+    spanBlend565(dst + j * SCREEN_WIDTH, SCREEN_WIDTH, COLOR_BG, 180);
+  }
+
+  // Opaque pixels not already covered by the memcpy
+  if (statusRunsOverflow) {
+    for (int i = 0; i < STATUS_BAR_HEIGHT * SCREEN_WIDTH; i++) {
+      if (lay[i] != STATUS_BAR_KEY) dst[i] = lay[i];
+    }
+  } else {
+    for (int i = 0; i < statusRunCount; i++) {
+      const StatusRun& r = statusRuns[i];
+      if (r.y < y) continue;
+      int32_t off = r.y * SCREEN_WIDTH + r.x;
+      memcpy(dst + off, lay + off, r.len * sizeof(uint16_t));
+    }
+  }
+
+  canvas.setTextSize(1);
 }
 void showStatus(String message, int delayMs) {
   canvas.fillScreen(COLOR_BG);
@@ -7141,43 +10040,13 @@ void showStatus(String message, int delayMs) {
   }
 
 
-  canvas.setTextColor(COLOR_TEXT);
-  canvas.setTextSize(2);
-
+  // Size 2; wrap before the right edge of the box
+  static TextLayout statusLayout;
   int textStartX = iconX + 40;
-  int cursorY = boxY + 20;
-  int cursorX = textStartX;
-  String word = "";
-
-  for (unsigned int i = 0; i < message.length(); i++) {
-    char c = message.charAt(i);
-    if (c == ' ' || c == '\n' || i == message.length() - 1) {
-      if (i == message.length() - 1 && c != ' ' && c != '\n') word += c;
-
-      int16_t x1, y1;
-      uint16_t w, h;
-      canvas.getTextBounds(word, 0, 0, &x1, &y1, &w, &h);
-
-      if (cursorX + w > boxX + boxW - 15) {
-        cursorY += 18;
-        cursorX = textStartX;
-      }
+  textLayoutSync(statusLayout, message, textLayoutHash(message), 2, boxX + boxW - 15 - textStartX, 18, true, INT32_MAX);
+  textLayoutDraw(statusLayout, message, textStartX, boxY + 20, INT16_MIN, INT16_MAX, COLOR_TEXT);
 
-      canvas.setCursor(cursorX, cursorY);
-      canvas.print(word);
-      cursorX += w + 12; // 12 is width of a char in size 2
-
-      if (c == '\n') {
-        cursorY += 18;
-        cursorX = textStartX;
-      }
-      word = "";
-    } else {
-      word += c;
-    }
-  }
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
+  pushCanvas();
   if (delayMs > 0) delay(delayMs);
 }
 
@@ -7233,7 +10102,7 @@ void showProgressBar(String title, int percent) {
   canvas.print(progressText);
 
 
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
+  pushCanvas();
 }
 
 void analyzeEarthquakeAI() {
@@ -7289,7 +10158,6 @@ void drawEarthquakeMonitor() {
     canvas.setTextColor(COLOR_DIM);
     canvas.setCursor(SCREEN_WIDTH/2 - 45, 80);
     canvas.print("Loading data...");
-    tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
     return;
   }
 
@@ -7298,7 +10166,6 @@ void drawEarthquakeMonitor() {
     canvas.setTextColor(COLOR_WARN);
     canvas.setCursor(SCREEN_WIDTH/2 - 60, 80);
     canvas.print("No earthquakes found");
-    tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
     return;
   }
 
@@ -7370,8 +10237,6 @@ void drawEarthquakeMonitor() {
   canvas.setTextColor(COLOR_DIM);
   canvas.setCursor(10, footerY + 4);
   canvas.printf("%d results", earthquakeCount);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawEarthquakeDetail() {
@@ -7475,8 +10340,6 @@ void drawEarthquakeDetail() {
   canvas.setTextSize(1);
   canvas.setTextColor(COLOR_DIM);
   canvas.setCursor(10, footerY + 4);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 int eqSettingsCursor = 0;
@@ -7504,7 +10367,6 @@ void drawEarthquakeMap() {
   if (!eq.isValid) {
     canvas.setCursor(50, 80);
     canvas.print("No data to map");
-    tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
     return;
   }
 
@@ -7581,8 +10443,6 @@ void drawEarthquakeMap() {
   canvas.drawFastHLine(0, SCREEN_HEIGHT - 15, SCREEN_WIDTH, COLOR_BORDER);
   canvas.setTextColor(COLOR_DIM);
   canvas.setCursor(10, SCREEN_HEIGHT - 12);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawEarthquakeSettings() {
@@ -7603,6 +10463,8 @@ void drawEarthquakeSettings() {
   int footerY = SCREEN_HEIGHT - 15;
   int visibleHeight = footerY - listY;
   canvas.setTextSize(1);
+  animSetTarget(eqSettingsAnim, eqSettingsCursor * itemHeight);
+  float eqSettingsScroll = animValue(eqSettingsAnim);
 
   // Calculate Viewport Scroll
   float viewScroll = 0;
@@ -7666,8 +10528,6 @@ void drawEarthquakeSettings() {
   canvas.drawFastHLine(0, SCREEN_HEIGHT - 15, SCREEN_WIDTH, COLOR_BORDER);
   canvas.setTextColor(COLOR_DIM);
   canvas.setCursor(10, SCREEN_HEIGHT - 12);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 // ===== ULTIMATE TIC-TAC-TOE LOGIC =====
@@ -8005,7 +10865,7 @@ void aiMakeMove() {
   switch (uttt.aiDifficulty) {
     case DIFF_EASY:
       {
-        int randIdx = random(moveCount);
+        int randIdx = rngBelow(rngGame, moveCount);
         utttAIMoveBoard = moves[randIdx].board;
         utttAIMoveCell = moves[randIdx].cell;
         return;
@@ -8119,8 +10979,6 @@ void drawUTTT() {
 
   canvas.setCursor(SCREEN_WIDTH - 80, footerY);
   canvas.print("L=Undo R=Menu");
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawSmallBoard(int x, int y, int boardIdx) {
@@ -8221,8 +11079,6 @@ void drawUTTTGameOver() {
   canvas.print("SEL = New Game");
   canvas.setCursor(40, 145);
   canvas.print("L+R = Main Menu");
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 static int utttMenuCursor = 0;
@@ -8258,8 +11114,6 @@ void drawUTTTMenu() {
     canvas.print(options[i]);
     y += 15;
   }
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 // ===== INPUT HANDLING =====
@@ -8288,39 +11142,32 @@ void handleUTTTInput() {
     return;
   }
 
-  if (digitalRead(BTN_UP) == BTN_ACT) {
+  if (buttonCombo(BTN_LEFT, BTN_RIGHT)) {
+    changeState(STATE_MAIN_MENU);
+    return;
+  }
+
+  if (buttonHit(BTN_UP)) {
     if (utttCursorY > 0) utttCursorY--;
     ledQuickFlash();
-    delay(150);
   }
 
-  if (digitalRead(BTN_DOWN) == BTN_ACT) {
+  if (buttonHit(BTN_DOWN)) {
     if (utttCursorY < 8) utttCursorY++;
     ledQuickFlash();
-    delay(150);
   }
 
-  if (digitalRead(BTN_LEFT) == BTN_ACT) {
-    if (digitalRead(BTN_RIGHT) == BTN_ACT) {
-       changeState(STATE_MAIN_MENU);
-       return;
-    }
+  if (buttonHit(BTN_LEFT)) {
     if (utttCursorX > 0) utttCursorX--;
     ledQuickFlash();
-    delay(150);
   }
 
-  if (digitalRead(BTN_RIGHT) == BTN_ACT) {
-    if (digitalRead(BTN_LEFT) == BTN_ACT) {
-       changeState(STATE_MAIN_MENU);
-       return;
-    }
+  if (buttonHit(BTN_RIGHT)) {
     if (utttCursorX < 8) utttCursorX++;
     ledQuickFlash();
-    delay(150);
   }
 
-  if (digitalRead(BTN_SELECT) == BTN_ACT) {
+  if (buttonHit(BTN_SELECT)) {
     int boardIdx = (utttCursorY / 3) * 3 + (utttCursorX / 3);
     int cellIdx = (utttCursorY % 3) * 3 + (utttCursorX % 3);
 
@@ -8330,28 +11177,24 @@ void handleUTTTInput() {
     } else {
       ledError();
     }
-    delay(200);
   }
 
-  if (digitalRead(BTN_BACK) == BTN_ACT) {
+  if (buttonHit(BTN_BACK)) {
     undoUTTTMove();
     ledQuickFlash();
-    delay(200);
   }
 }
 
 void handleUTTTMenuInput() {
-  if (digitalRead(BTN_DOWN) == BTN_ACT) {
+  if (buttonHit(BTN_DOWN)) {
     utttMenuCursor = (utttMenuCursor + 1) % 5;
     ledQuickFlash();
-    delay(150);
   }
-  if (digitalRead(BTN_UP) == BTN_ACT) {
+  if (buttonHit(BTN_UP)) {
     utttMenuCursor = (utttMenuCursor - 1 + 5) % 5;
     ledQuickFlash();
-    delay(150);
   }
-  if (digitalRead(BTN_SELECT) == BTN_ACT) {
+  if (buttonHit(BTN_SELECT)) {
     ledSuccess();
     switch (utttMenuCursor) {
       case 0: startNewUTTT(true, DIFF_EASY); break;
@@ -8360,20 +11203,18 @@ void handleUTTTMenuInput() {
       case 3: startNewUTTT(false, 0); break;
       case 4: changeState(STATE_MAIN_MENU); break;
     }
-    delay(200);
   }
-  if (digitalRead(BTN_LEFT) == BTN_ACT && digitalRead(BTN_RIGHT) == BTN_ACT) {
+  if (buttonCombo(BTN_LEFT, BTN_RIGHT)) {
     changeState(STATE_MAIN_MENU);
   }
 }
 
 void handleUTTTGameOverInput() {
-  if (digitalRead(BTN_SELECT) == BTN_ACT) {
+  if (buttonHit(BTN_SELECT)) {
     ledSuccess();
     changeState(STATE_UTTT_MENU);
-    delay(200);
   }
-  if (digitalRead(BTN_LEFT) == BTN_ACT && digitalRead(BTN_RIGHT) == BTN_ACT) {
+  if (buttonCombo(BTN_LEFT, BTN_RIGHT)) {
     changeState(STATE_MAIN_MENU);
   }
 }
@@ -8388,9 +11229,11 @@ void drawMainMenuCool() {
     int centerX = SCREEN_WIDTH / 2;
     int centerY = 75;
     int itemGap = 85;
+    animSetTarget(menuScrollAnim, menuSelection * itemGap);
+    float menuScroll = animValue(menuScrollAnim);
 
     for (int i = 0; i < numItems; i++) {
-        float distance = i - (menuScrollCurrent / (float)itemGap);
+        float distance = i - (menuScroll / (float)itemGap);
         float scale = 1.0f - (abs(distance) * 0.45f);
         scale = max(0.0f, scale);
 
@@ -8404,8 +11247,7 @@ void drawMainMenuCool() {
         if (abs(distance) < 0.5f) {
             color = COLOR_ACCENT;
             drawSelectionGlow(x - 25, centerY - 25, 50, 50, COLOR_ACCENT);
-            float pulse = (sin(millis() / 150.0f) + 1.0f) * 0.1f;
-            scale += pulse;
+            scale += fxWave(fxPhase(millis(), 942)) * (0.2f / FX_ONE_Q16);
 
             canvas.setTextSize(2);
             canvas.setTextColor(COLOR_TEXT);
@@ -8418,29 +11260,8 @@ void drawMainMenuCool() {
             color = COLOR_DIM;
         }
 
-        int iconSize = 32 * scale;
-        drawScaledBitmap(x - (iconSize / 2), centerY - (iconSize / 2), menuIcons[i], 32, 32, scale, color);
-    }
-    tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
-}
-
-void updateParticles() {
-  if (!particlesInit) {
-    for (int i = 0; i < NUM_PARTICLES; i++) {
-      particles[i].x = random(0, SCREEN_WIDTH);
-      particles[i].y = random(0, SCREEN_HEIGHT);
-      particles[i].speed = random(10, 50) / 10.0f;
-      particles[i].size = random(1, 3);
-    }
-    particlesInit = true;
-  }
-  for (int i = 0; i < NUM_PARTICLES; i++) {
-    particles[i].x -= particles[i].speed;
-    if (particles[i].x < 0) {
-      particles[i].x = SCREEN_WIDTH;
-      particles[i].y = random(0, SCREEN_HEIGHT);
+        drawIconSprite(x, centerY, i, scale, color);
     }
-  }
 }
 
 // ============ AI MODE SELECTION SCREEN ============
@@ -8485,8 +11306,6 @@ void drawGroqModelSelect() {
   canvas.setTextSize(1);
   canvas.setTextColor(COLOR_DIM);
   canvas.setCursor(10, SCREEN_HEIGHT - 12);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void showAIModeSelection(int x_offset) {
@@ -8536,8 +11355,6 @@ void showAIModeSelection(int x_offset) {
   canvas.setTextColor(COLOR_DIM);
   canvas.setTextSize(1);
   canvas.setCursor(10, SCREEN_HEIGHT - 12);
-  
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 // ============ WIFI MENU ============
@@ -8580,8 +11397,6 @@ void showWiFiMenu(int x_offset) {
   // Menu Items
   const char* menuItems[] = {"Scan Networks", "Forget Network", "Back"};
   drawScrollableMenu(menuItems, 3, 95, 25, 5);
-  
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 // ============ WIFI SCAN ============
@@ -8667,8 +11482,6 @@ void displayWiFiNetworks(int x_offset) {
       canvas.print((networkCount + wifiPerPage - 1) / wifiPerPage);
     }
   }
-  
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 // ============ KEYBOARD ============
@@ -8781,13 +11594,78 @@ void drawKeyboard(int x_offset) {
   canvas.print(currentKeyboardMode == MODE_LOWER ? "abc" : (currentKeyboardMode == MODE_UPPER ? "ABC" : "123"));
   
   canvas.setCursor(SCREEN_WIDTH - 80, SCREEN_HEIGHT - 10);
-  
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
+}
+
+// ============ SCROLL VIEWPORT ============
+// Text viewers scroll a band of rows between a fixed header and footer. The
+// ST7789's own vertical scroll (VSCRDEF/VSCSAD) runs along the panel's long
+// axis, which is screen x in our landscape rotation, so it can't move text up
+// and down. The band is shifted inside the canvas instead: when the canvas
+// still holds the band's previous frame, scrollViewportBegin() moves the rows
+// by the scroll delta and only the exposed rows are cleared and redrawn.
+// Callers draw the band first and the fixed regions over it afterwards, which
+// also clips lines that straddle the band edges.
+struct ScrollViewport {
+  int16_t top = 0, bottom = 0; // Band rows [top, bottom)
+  int32_t offset = 0;          // Scroll offset the band was drawn at
+  uint32_t contentKey = 0;     // Caller's hash of what the band shows
+  uint32_t frame = 0;          // displayFrameCount when it was drawn
+  bool valid = false;
+};
+
+// Sets [y0, y1) to the rows that must be repainted (already cleared to bg);
+// empty when nothing moved.
+void scrollViewportBegin(ScrollViewport& v, int16_t top, int16_t bottom, int32_t offset,
+                         uint32_t contentKey, uint16_t bg, int16_t& y0, int16_t& y1) {
+  int16_t h = bottom - top;
+  int32_t delta = offset - v.offset;
+  bool reuse = v.valid && v.top == top && v.bottom == bottom && v.contentKey == contentKey &&
+               displayFrameCount == v.frame + 1 && abs(delta) < h;
+
+  y0 = top;
+  y1 = bottom;
+  if (reuse) {
+    uint16_t* band = canvas.getBuffer() + (int32_t)top * SCREEN_WIDTH;
+    if (delta > 0) {
+      memmove(band, band + delta * SCREEN_WIDTH, (size_t)(h - delta) * SCREEN_WIDTH * sizeof(uint16_t));
+      y0 = bottom - delta;
+    } else if (delta < 0) {
+      memmove(band - delta * SCREEN_WIDTH, band, (size_t)(h + delta) * SCREEN_WIDTH * sizeof(uint16_t));
+      y1 = top - delta;
+    } else {
+      y1 = y0;
+    }
+  }
+  if (y1 > y0) canvas.fillRect(0, y0, SCREEN_WIDTH, y1 - y0, bg);
+
+  v.top = top;
+  v.bottom = bottom;
+  v.offset = offset;
+  v.contentKey = contentKey;
+}
+
+// Call once the band is drawn. Anything composited over the canvas after the
+// screen (transitions, profiler overlay) makes the next frame start over.
+void scrollViewportEnd(ScrollViewport& v) {
+  v.frame = displayFrameCount;
+  v.valid = transitionState == TRANSITION_NONE && !showProfiler;
+  displayScrollFrame = v.valid;
 }
 
 // ============ CHAT RESPONSE ============
 void displayResponse() {
-  canvas.fillScreen(COLOR_BG);
+  static TextLayout responseLayout;
+  static ScrollViewport responseViewport;
+  int32_t originY = 48 - scrollOffset;
+  textLayoutSync(responseLayout, aiResponse, textVersion, 1, SCREEN_WIDTH - 15, 10, true, SCREEN_HEIGHT - originY);
+
+  int16_t y0, y1;
+  scrollViewportBegin(responseViewport, 40, SCREEN_HEIGHT, scrollOffset,
+                      responseLayout.version ^ responseLayout.length, COLOR_BG, y0, y1);
+  if (y1 > y0) textLayoutDraw(responseLayout, aiResponse, 5, originY, y0, y1, COLOR_TEXT);
+  scrollViewportEnd(responseViewport);
+
+  canvas.fillRect(0, 0, SCREEN_WIDTH, 40, COLOR_BG);
   drawStatusBar();
   canvas.fillRect(0, 15, SCREEN_WIDTH, 25, COLOR_PRIMARY);
   canvas.setTextColor(COLOR_BG);
@@ -8800,39 +11678,6 @@ void displayResponse() {
     canvas.setCursor(75, 20);
     canvas.print("STANDARD AI");
   }
-  
-  canvas.setTextSize(1);
-  canvas.setTextColor(COLOR_TEXT);
-  int y = 48 - scrollOffset;
-  int lineHeight = 10;
-  String word = "";
-  int x = 5;
-  for (unsigned int i = 0; i < aiResponse.length(); i++) {
-    char c = aiResponse.charAt(i);
-    if (c == ' ' || c == '\n' || i == aiResponse.length() - 1) {
-      if (i == aiResponse.length() - 1 && c != ' ' && c != '\n') {
-        word += c;
-      }
-      int wordWidth = word.length() * 6;
-      if (x + wordWidth > SCREEN_WIDTH - 10) {
-        y += lineHeight;
-        x = 5;
-      }
-      if (y >= 40 && y < SCREEN_HEIGHT - 5) {
-        canvas.setCursor(x, y);
-        canvas.print(word);
-      }
-      x += wordWidth + 6;
-      word = "";
-      if (c == '\n') {
-        y += lineHeight;
-        x = 5;
-      }
-    } else {
-      word += c;
-    }
-  }
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 // ============ LOADING ANIMATION ============
@@ -8847,16 +11692,15 @@ void showLoadingAnimation(int x_offset) {
   int cy = SCREEN_HEIGHT / 2 + 20;
   int r = 20;
   for (int i = 0; i < 8; i++) {
-    float angle = (loadingFrame + i) * (2 * PI / 8);
-    int x = cx + cos(angle) * r;
-    int y = cy + sin(angle) * r;
+    uint16_t angle = (loadingFrame + i) * (65536 / 8);
+    int x = cx + fxMulQ15(fxCos(angle), r);
+    int y = cy + fxMulQ15(fxSin(angle), r);
     if (i == 0) {
       canvas.fillCircle(x, y, 4, COLOR_ACCENT);
     } else {
       canvas.drawCircle(x, y, 2, COLOR_DIM);
     }
   }
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 // ============ SYSTEM INFO ============
@@ -8915,8 +11759,6 @@ void drawDeviceInfo(int x_offset) {
   // Footer
   canvas.setTextColor(COLOR_DIM);
   canvas.setCursor(10, SCREEN_HEIGHT - 12);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 // ============ COURIER TRACKER ============
@@ -8989,8 +11831,6 @@ void drawCourierTool() {
   canvas.setTextColor(COLOR_DIM);
   canvas.setTextSize(1);
   canvas.setCursor(10, SCREEN_HEIGHT - 12);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void checkResiReal() {
@@ -9001,6 +11841,7 @@ void checkResiReal() {
   isTracking = true;
   courierStatus = "FETCHING...";
   drawCourierTool();
+  pushCanvas();
 
   if (binderbyteApiKey.length() == 0 || binderbyteApiKey.startsWith("PASTE_")) {
     courierStatus = "NO API KEY";
@@ -9008,6 +11849,7 @@ void checkResiReal() {
     return;
   }
 
+  CanvasHeapRelief heapRelief;
   WiFiClient client;
   HTTPClient http;
   String url = "http://api.binderbyte.com/v1/track?api_key=" + binderbyteApiKey + "&courier=" + bb_kurir + "&awb=" + bb_resi;
@@ -9121,8 +11963,6 @@ void drawSystemMenu() {
 
   const char* items[] = {"Device Info", "Security", "System Monitor", "Brightness", "Back"};
   drawScrollableMenu(items, 5, 45, 25, 4);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawPinKeyboard() {
@@ -9173,7 +12013,6 @@ void drawPinLock(bool isChanging) {
   }
 
   drawPinKeyboard();
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void sendToGemini() {
@@ -9182,6 +12021,7 @@ void sendToGemini() {
   
   for (int i = 0; i < 5; i++) {
     showLoadingAnimation(0);
+    pushCanvas();
     delay(100);
     loadingFrame++;
   }
@@ -9189,6 +12029,7 @@ void sendToGemini() {
   if (geminiApiKey.length() == 0 || geminiApiKey.startsWith("PASTE_")) {
     ledError();
     aiResponse = "Gemini API Key not found. Please add it to /api_keys.json on your SD card.";
+    textVersion++;
     currentState = STATE_CHAT_RESPONSE;
     scrollOffset = 0;
     return;
@@ -9201,11 +12042,13 @@ void sendToGemini() {
     } else {
       aiResponse = "Error: WiFi not connected. Please connect to a network first.";
     }
+    textVersion++;
     currentState = STATE_CHAT_RESPONSE;
     scrollOffset = 0;
     return;
   }
   
+  CanvasHeapRelief heapRelief;
   HTTPClient http;
   String url = String(geminiEndpoint) + "?key=" + geminiApiKey;
   http.begin(url);
@@ -9305,6 +12148,7 @@ void sendToGemini() {
   }
   
   http.end();
+  textVersion++;
   currentState = STATE_CHAT_RESPONSE;
   scrollOffset = 0;
 }
@@ -9315,6 +12159,7 @@ void sendToGroq() {
 
   for (int i = 0; i < 5; i++) {
     showLoadingAnimation(0);
+    pushCanvas();
     delay(100);
     loadingFrame++;
   }
@@ -9322,6 +12167,7 @@ void sendToGroq() {
   if (groqApiKey.length() == 0 || groqApiKey.startsWith("PASTE_")) {
     ledError();
     aiResponse = "Groq API Key not found. Please add it to /api_keys.json on your SD card.";
+    textVersion++;
     currentState = STATE_CHAT_RESPONSE;
     scrollOffset = 0;
     return;
@@ -9330,11 +12176,13 @@ void sendToGroq() {
   if (WiFi.status() != WL_CONNECTED) {
     ledError();
     aiResponse = "Error: WiFi not connected. Please connect to a network first.";
+    textVersion++;
     currentState = STATE_CHAT_RESPONSE;
     scrollOffset = 0;
     return;
   }
 
+  CanvasHeapRelief heapRelief;
   WiFiClientSecure client;
   client.setInsecure(); // Skip certificate validation for simplicity
   HTTPClient http;
@@ -9403,6 +12251,7 @@ void sendToGroq() {
   }
 
   http.end();
+  textVersion++;
   currentState = STATE_CHAT_RESPONSE;
   scrollOffset = 0;
 }
@@ -9424,6 +12273,7 @@ void fetchPomodoroQuote() {
     return;
   }
 
+  CanvasHeapRelief heapRelief;
   HTTPClient http;
   String url = String(geminiEndpoint) + "?key=" + geminiApiKey;
   http.begin(url);
@@ -9463,23 +12313,102 @@ void fetchPomodoroQuote() {
 
 
 // ============ TRANSITION SYSTEM ============
+// A transition snapshots the outgoing frame when the state changes and the
+// incoming frame the first time it is drawn, then animates by compositing the
+// two (PSRAM) snapshots into the canvas. Neither screen is redrawn while the
+// transition runs. Without PSRAM the state changes with a plain cut.
+uint16_t* transitionFrom = nullptr;
+uint16_t* transitionTo = nullptr;
+
+bool allocTransitionBuffers() {
+  if (transitionFrom != nullptr && transitionTo != nullptr) return true;
+  if (!psramFound()) return false;
+  size_t bytes = SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(uint16_t);
+  if (transitionFrom == nullptr) transitionFrom = (uint16_t*)ps_malloc(bytes);
+  if (transitionTo == nullptr) transitionTo = (uint16_t*)ps_malloc(bytes);
+  return transitionFrom != nullptr && transitionTo != nullptr;
+}
+
+TransitionStyle pickTransitionStyle(AppState from, AppState to) {
+  if (from == STATE_SCREENSAVER || to == STATE_SCREENSAVER) return TRANSITION_FADE;
+  if (to >= STATE_VIS_STARFIELD && to <= STATE_GAME_BREAKOUT) return TRANSITION_WIPE;
+  if (to == STATE_MAIN_MENU || to == previousState) return TRANSITION_SLIDE_BACK;
+  return TRANSITION_SLIDE;
+}
+
+// Compose the transition frame for progress t (0..1) into the canvas
+void composeTransition(float t) {
+  uint16_t* dst = canvas.getBuffer();
+  float e = t * t * (3.0f - 2.0f * t);  // smoothstep
+  int off = (int)(e * SCREEN_WIDTH + 0.5f);
+  if (off > SCREEN_WIDTH) off = SCREEN_WIDTH;
+
+  for (int y = 0; y < SCREEN_HEIGHT; y++) {
+    uint16_t* row = dst + y * SCREEN_WIDTH;
+    const uint16_t* a = transitionFrom + y * SCREEN_WIDTH;
+    const uint16_t* b = transitionTo + y * SCREEN_WIDTH;
+    switch (transitionStyle) {
+      case TRANSITION_SLIDE:       // old leaves to the left, new follows
+        spanCopy565(row, a + off, SCREEN_WIDTH - off);
+        spanCopy565(row + SCREEN_WIDTH - off, b, off);
+        break;
+      case TRANSITION_SLIDE_BACK:  // old leaves to the right
+        spanCopy565(row, b + SCREEN_WIDTH - off, off);
+        spanCopy565(row + off, a, SCREEN_WIDTH - off);
+        break;
+      case TRANSITION_FADE:
+        spanMix565(row, a, b, SCREEN_WIDTH, (uint8_t)(e * 255.0f));
+        break;
+      case TRANSITION_WIPE:        // new uncovered left to right
+        spanCopy565(row, b, off);
+        spanCopy565(row + off, a + off, SCREEN_WIDTH - off);
+        break;
+    }
+  }
+}
+
+void drawCurrentScreen();
+
+// Produce the next transition frame in the canvas
+void renderTransitionFrame() {
+  if (transitionState == TRANSITION_OUT) {
+    currentState = transitionTargetState;
+    drawCurrentScreen();
+    frameShakeX = 0;
+    frameShakeY = 0;
+    if (transitionFrom == nullptr || transitionTo == nullptr) {
+      transitionState = TRANSITION_NONE;  // no snapshots: plain cut
+      return;
+    }
+    memcpy(transitionTo, canvas.getBuffer(), SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(uint16_t));
+    transitionState = TRANSITION_IN;
+    transitionProgress = 0.0f;
+  }
+
+  composeTransition(transitionProgress);
+  if (transitionProgress >= 1.0f) {
+    transitionState = TRANSITION_NONE;
+  }
+}
+
 void changeState(AppState newState) {
   if (transitionState == TRANSITION_NONE && currentState != newState) {
     screenIsDirty = true; // Request a redraw for the new state
+    transitionStyle = pickTransitionStyle(currentState, newState);
+    if (allocTransitionBuffers()) {
+      memcpy(transitionFrom, canvas.getBuffer(), SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(uint16_t));
+    }
     transitionTargetState = newState;
     transitionState = TRANSITION_OUT;
     transitionProgress = 0.0f;
     previousState = currentState;
+    buttonsIgnoreHeld();
 
     // Reset Menu Scrolls
-    genericMenuScrollCurrent = 0.0f;
-    genericMenuVelocity = 0.0f;
-    prayerSettingsScroll = 0.0f;
-    prayerSettingsVelocity = 0.0f;
-    citySelectScroll = 0.0f;
-    citySelectVelocity = 0.0f;
-    eqSettingsScroll = 0.0f;
-    eqSettingsVelocity = 0.0f;
+    animSnap(genericMenuAnim, 0.0f);
+    animSnap(prayerSettingsAnim, 0.0f);
+    animSnap(citySelectAnim, 0.0f);
+    animSnap(eqSettingsAnim, 0.0f);
   }
 }
 
@@ -9493,6 +12422,7 @@ void fetchRandomWiki() {
   wikiIsLoading = true;
   refreshCurrentScreen(); // Show loading status
 
+  CanvasHeapRelief heapRelief;
   HTTPClient http;
   http.begin("https://id.wikipedia.org/api/rest_v1/page/random/summary");
   http.addHeader("User-Agent", "AI-Pocket-S3-Viewer/2.2 (https://github.com/IhsanSubaru)");
@@ -9507,6 +12437,7 @@ void fetchRandomWiki() {
     if (!error) {
       currentArticle.title = doc["title"].as<String>();
       currentArticle.extract = doc["extract"].as<String>();
+      textVersion++;
       currentArticle.url = doc["content_urls"]["desktop"]["page"].as<String>();
       wikiScrollOffset = 0;
       ledSuccess();
@@ -9530,6 +12461,7 @@ void fetchWikiSearch(String query) {
   wikiIsLoading = true;
   refreshCurrentScreen();
 
+  CanvasHeapRelief heapRelief;
   HTTPClient http;
   String encodedQuery = query;
   encodedQuery.replace(" ", "%20");
@@ -9552,6 +12484,7 @@ void fetchWikiSearch(String query) {
           JsonObject page = kv.value().as<JsonObject>();
           currentArticle.title = page["title"].as<String>();
           currentArticle.extract = page["extract"].as<String>();
+          textVersion++;
           currentArticle.url = page["fullurl"].as<String>();
           wikiScrollOffset = 0;
           ledSuccess();
@@ -9593,7 +12526,35 @@ void saveWikiBookmark() {
 }
 
 void drawWikiViewer() {
-  canvas.fillScreen(COLOR_BG);
+  // Article Content
+  static TextLayout titleLayout;
+  static TextLayout extractLayout;
+  static ScrollViewport wikiViewport;
+  static const String noTitle = "No Article Loaded";
+  static const String noExtract = "Press SELECT to fetch a random article.";
+  const String& title = currentArticle.title.length() ? currentArticle.title : noTitle;
+  const String& extract = currentArticle.extract.length() ? currentArticle.extract : noExtract;
+  int32_t titleY = 50 - wikiScrollOffset;
+
+  // Title: size 2, wraps on spaces only
+  textLayoutSync(titleLayout, title, textVersion, 2, SCREEN_WIDTH - 20, 20, false, INT32_MAX);
+  int32_t extractY = titleY + textLayoutLastY(titleLayout) + 25;
+  textLayoutSync(extractLayout, extract, textVersion, 1, SCREEN_WIDTH - 25, 12, true, SCREEN_HEIGHT - 15 - extractY);
+
+  int16_t y0, y1;
+  scrollViewportBegin(wikiViewport, 41, SCREEN_HEIGHT - 15, wikiScrollOffset,
+                      extractLayout.version ^ titleLayout.length ^ extractLayout.length, COLOR_BG, y0, y1);
+  if (y1 > y0) {
+    textLayoutDraw(titleLayout, title, 10, titleY, y0, y1, COLOR_WARN); // Yellow
+
+    canvas.drawFastHLine(10, extractY - 5, SCREEN_WIDTH - 20, COLOR_BORDER);
+
+    // Extract
+    textLayoutDraw(extractLayout, extract, 10, extractY, y0, y1, COLOR_TEXT);
+  }
+  scrollViewportEnd(wikiViewport);
+
+  canvas.fillRect(0, 0, SCREEN_WIDTH, 41, COLOR_BG);
   drawStatusBar();
 
   // Header
@@ -9612,82 +12573,12 @@ void drawWikiViewer() {
     canvas.print("Loading...");
   }
 
-  // Article Content
-  int y = 50 - wikiScrollOffset;
-
-  // Draw Title
-  canvas.setTextSize(2);
-  canvas.setTextColor(COLOR_WARN); // Yellow
-
-  // Simple word wrap for Title
-  String title = currentArticle.title;
-  if (title.length() == 0) title = "No Article Loaded";
-
-  int x = 10;
-  String word = "";
-  for (unsigned int i = 0; i < title.length(); i++) {
-    char c = title.charAt(i);
-    if (c == ' ' || i == title.length() - 1) {
-      if (i == title.length() - 1) word += c;
-      int wordW = word.length() * 12;
-      if (x + wordW > SCREEN_WIDTH - 10) {
-        y += 20;
-        x = 10;
-      }
-      if (y > 40 && y < SCREEN_HEIGHT - 20) {
-        canvas.setCursor(x, y);
-        canvas.print(word);
-      }
-      x += wordW + 12;
-      word = "";
-    } else {
-      word += c;
-    }
-  }
-
-  y += 25;
-  canvas.drawFastHLine(10, y - 5, SCREEN_WIDTH - 20, COLOR_BORDER);
-
-  // Draw Extract
-  canvas.setTextSize(1);
-  canvas.setTextColor(COLOR_TEXT);
-  x = 10;
-  word = "";
-  String extract = currentArticle.extract;
-  if (extract.length() == 0) extract = "Press SELECT to fetch a random article.";
-
-  for (unsigned int i = 0; i < extract.length(); i++) {
-    char c = extract.charAt(i);
-    if (c == ' ' || c == '\n' || i == extract.length() - 1) {
-      if (i == extract.length() - 1 && c != ' ' && c != '\n') word += c;
-      int wordW = word.length() * 6;
-      if (x + wordW > SCREEN_WIDTH - 15) {
-        y += 12;
-        x = 10;
-      }
-      if (y > 40 && y < SCREEN_HEIGHT - 20) {
-        canvas.setCursor(x, y);
-        canvas.print(word);
-      }
-      x += wordW + 6;
-      word = "";
-      if (c == '\n') {
-        y += 12;
-        x = 10;
-      }
-    } else {
-      word += c;
-    }
-  }
-
   // Footer
   canvas.fillRect(0, SCREEN_HEIGHT - 15, SCREEN_WIDTH, 15, COLOR_PANEL);
   canvas.drawFastHLine(0, SCREEN_HEIGHT - 15, SCREEN_WIDTH, COLOR_BORDER);
   canvas.setTextSize(1);
   canvas.setTextColor(COLOR_DIM);
   canvas.setCursor(5, SCREEN_HEIGHT - 12);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 // ===== PRAYER TIMES UI =====
@@ -9713,8 +12604,8 @@ void drawPrayerIcon(int x, int y, int type) {
     case 3: // Dzuhur - Sun
       canvas.drawCircle(x + 8, y + 8, 4, COLOR_WARN); // Yellow
       for(int i=0; i<8; i++) {
-        float a = i * PI / 4;
-        canvas.drawLine(x+8+cos(a)*5, y+8+sin(a)*5, x+8+cos(a)*7, y+8+sin(a)*7, COLOR_WARN);
+        int32_t c = fxCos(i * 8192), sn = fxSin(i * 8192);
+        canvas.drawLine(x+8+fxMulQ15(c, 5), y+8+fxMulQ15(sn, 5), x+8+fxMulQ15(c, 7), y+8+fxMulQ15(sn, 7), COLOR_WARN);
       }
       break;
     case 4: // Ashar - Afternoon Sun
@@ -9759,7 +12650,6 @@ void drawPrayerTimes() {
       canvas.setCursor((SCREEN_WIDTH - w) / 2, 100);
       canvas.print(loadMsg);
     }
-    tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
     return;
   }
 
@@ -9865,33 +12755,18 @@ void drawPrayerTimes() {
   canvas.getTextBounds(qiblaStr, 0, 0, &tx1, &ty1, &tw, &th);
   canvas.setCursor(SCREEN_WIDTH - 15 - tw, footerY + 2);
   canvas.print(qiblaStr);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void handlePrayerTimesInput() {
-  if (digitalRead(BTN_SELECT) == BTN_ACT) {
-    unsigned long pressTime = millis();
-    bool longPressed = false;
-
-    while (digitalRead(BTN_SELECT) == BTN_ACT) {
-      if (millis() - pressTime > 1000) {
-        longPressed = true;
-        ledQuickFlash();
-        changeState(STATE_PRAYER_SETTINGS);
-        break;
-      }
-      delay(10);
-    }
+  if (buttonLong(BTN_SELECT)) {
+    ledQuickFlash();
+    changeState(STATE_PRAYER_SETTINGS);
+  }
 
-    if (!longPressed) {
-      // Short press: retry fetch if it previously failed
-      if (!currentPrayer.isValid && prayerFetchFailed) {
-        ledSuccess();
-        fetchPrayerTimes();
-        delay(200);
-      }
-    }
+  // Short press: retry fetch if it previously failed
+  if (buttonShort(BTN_SELECT) && !currentPrayer.isValid && prayerFetchFailed) {
+    ledSuccess();
+    fetchPrayerTimes();
   }
 }
 
@@ -9928,6 +12803,8 @@ void drawCitySelect() {
   int footerY = SCREEN_HEIGHT - 15;
   int visibleHeight = footerY - listY;
   canvas.setTextSize(1);
+  animSetTarget(citySelectAnim, citySelectCursor * itemHeight);
+  float citySelectScroll = animValue(citySelectAnim);
 
   // Calculate Viewport Scroll
   float viewScroll = 0;
@@ -9959,33 +12836,23 @@ void drawCitySelect() {
   canvas.fillRect(0, SCREEN_HEIGHT - 15, SCREEN_WIDTH, 15, COLOR_PANEL);
   canvas.drawFastHLine(0, SCREEN_HEIGHT - 15, SCREEN_WIDTH, COLOR_BORDER);
   canvas.setTextColor(COLOR_DIM);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void handleCitySelectInput() {
-  if (digitalRead(BTN_LEFT) == BTN_ACT && digitalRead(BTN_RIGHT) == BTN_ACT) {
+  if (buttonCombo(BTN_LEFT, BTN_RIGHT)) {
     changeState(STATE_PRAYER_SETTINGS);
-    delay(200);
     return;
   }
 
-  static unsigned long lastMove = 0;
-  bool btnDown = (digitalRead(BTN_DOWN) == BTN_ACT);
-  bool btnUp = (digitalRead(BTN_UP) == BTN_ACT);
-
-  if (btnDown || btnUp) {
-    if (millis() - lastMove > 150) {
-      if (btnDown) citySelectCursor = (citySelectCursor + 1) % cityCount;
-      else citySelectCursor = (citySelectCursor - 1 + cityCount) % cityCount;
-      ledQuickFlash();
-      lastMove = millis();
-    }
-  } else {
-    lastMove = 0;
+  if (buttonHit(BTN_DOWN)) {
+    citySelectCursor = (citySelectCursor + 1) % cityCount;
+    ledQuickFlash();
+  } else if (buttonHit(BTN_UP)) {
+    citySelectCursor = (citySelectCursor - 1 + cityCount) % cityCount;
+    ledQuickFlash();
   }
 
-  if (digitalRead(BTN_SELECT) == BTN_ACT) {
+  if (buttonHit(BTN_SELECT)) {
     ledSuccess();
 
     // Update location data
@@ -10009,7 +12876,6 @@ void handleCitySelectInput() {
 
     showStatus("Location Updated!", 1000);
     changeState(STATE_PRAYER_SETTINGS);
-    delay(200);
   }
 }
 
@@ -10031,6 +12897,8 @@ void drawPrayerSettings() {
   int footerY = SCREEN_HEIGHT - 15;
   int visibleHeight = footerY - listY;
   canvas.setTextSize(1);
+  animSetTarget(prayerSettingsAnim, prayerSettingsCursor * itemHeight);
+  float prayerSettingsScroll = animValue(prayerSettingsAnim);
 
   // Calculate Viewport Scroll
   float viewScroll = 0;
@@ -10075,33 +12943,23 @@ void drawPrayerSettings() {
   canvas.fillRect(0, SCREEN_HEIGHT - 15, SCREEN_WIDTH, 15, COLOR_PANEL);
   canvas.drawFastHLine(0, SCREEN_HEIGHT - 15, SCREEN_WIDTH, COLOR_BORDER);
   canvas.setTextColor(COLOR_DIM);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void handlePrayerSettingsInput() {
-  if (digitalRead(BTN_LEFT) == BTN_ACT && digitalRead(BTN_RIGHT) == BTN_ACT) {
+  if (buttonCombo(BTN_LEFT, BTN_RIGHT)) {
     changeState(STATE_PRAYER_TIMES);
-    delay(200);
     return;
   }
 
-  static unsigned long lastMove = 0;
-  bool btnDown = (digitalRead(BTN_DOWN) == BTN_ACT);
-  bool btnUp = (digitalRead(BTN_UP) == BTN_ACT);
-
-  if (btnDown || btnUp) {
-    if (millis() - lastMove > 150) {
-      if (btnDown) prayerSettingsCursor = (prayerSettingsCursor + 1) % prayerSettingsCount;
-      else prayerSettingsCursor = (prayerSettingsCursor - 1 + prayerSettingsCount) % prayerSettingsCount;
-      ledQuickFlash();
-      lastMove = millis();
-    }
-  } else {
-    lastMove = 0;
+  if (buttonHit(BTN_DOWN)) {
+    prayerSettingsCursor = (prayerSettingsCursor + 1) % prayerSettingsCount;
+    ledQuickFlash();
+  } else if (buttonHit(BTN_UP)) {
+    prayerSettingsCursor = (prayerSettingsCursor - 1 + prayerSettingsCount) % prayerSettingsCount;
+    ledQuickFlash();
   }
 
-  if (digitalRead(BTN_SELECT) == BTN_ACT) {
+  if (buttonHit(BTN_SELECT)) {
     ledSuccess();
     switch (prayerSettingsCursor) {
       case 0:
@@ -10146,15 +13004,14 @@ void handlePrayerSettingsInput() {
         changeState(STATE_PRAYER_TIMES);
         break;
     }
-    delay(200);
   }
 }
 
 // ===== EARTHQUAKE INPUT HANDLERS =====
 void handleEarthquakeInput() {
-  if (digitalRead(BTN_LEFT) == BTN_ACT && digitalRead(BTN_RIGHT) == BTN_ACT) return;
+  if (buttonHeld(BTN_LEFT) && buttonHeld(BTN_RIGHT)) return;
 
-  if (digitalRead(BTN_DOWN) == BTN_ACT) {
+  if (buttonHit(BTN_DOWN)) {
     if (earthquakeCount > 0) {
       earthquakeCursor++;
       if (earthquakeCursor >= earthquakeCount) {
@@ -10170,7 +13027,7 @@ void handleEarthquakeInput() {
     ledQuickFlash();
   }
 
-  if (digitalRead(BTN_UP) == BTN_ACT) {
+  if (buttonHit(BTN_UP)) {
     earthquakeCursor--;
     if (earthquakeCursor < 0) earthquakeCursor = 0;
 
@@ -10182,7 +13039,7 @@ void handleEarthquakeInput() {
     ledQuickFlash();
   }
 
-  if (digitalRead(BTN_SELECT) == BTN_ACT) {
+  if (buttonHit(BTN_SELECT)) {
     // Show detail view
     if (earthquakeCount > 0 && earthquakeCursor < earthquakeCount) {
       selectedEarthquake = earthquakes[earthquakeCursor];
@@ -10191,7 +13048,7 @@ void handleEarthquakeInput() {
     ledSuccess();
   }
 
-  if (digitalRead(BTN_RIGHT) == BTN_ACT) {
+  if (buttonHit(BTN_RIGHT)) {
     // Open settings
     changeState(STATE_EARTHQUAKE_SETTINGS);
     ledQuickFlash();
@@ -10199,29 +13056,29 @@ void handleEarthquakeInput() {
 }
 
 void handleEarthquakeDetailInput() {
-  if (digitalRead(BTN_LEFT) == BTN_ACT && digitalRead(BTN_RIGHT) == BTN_ACT) return;
+  if (buttonHeld(BTN_LEFT) && buttonHeld(BTN_RIGHT)) return;
 
-  if (digitalRead(BTN_UP) == BTN_ACT) {
+  if (buttonHit(BTN_UP)) {
     analyzeEarthquakeAI();
     ledSuccess();
   }
 
-  if (digitalRead(BTN_SELECT) == BTN_ACT) {
+  if (buttonHit(BTN_SELECT)) {
     changeState(STATE_EARTHQUAKE_MAP);
     ledSuccess();
   }
 }
 
 void handleEarthquakeMapInput() {
-  if (digitalRead(BTN_LEFT) == BTN_ACT && digitalRead(BTN_RIGHT) == BTN_ACT) return;
+  if (buttonHeld(BTN_LEFT) && buttonHeld(BTN_RIGHT)) return;
 
-  if (digitalRead(BTN_DOWN) == BTN_ACT) {
+  if (buttonHit(BTN_DOWN)) {
     earthquakeCursor = (earthquakeCursor + 1) % earthquakeCount;
     selectedEarthquake = earthquakes[earthquakeCursor];
     ledQuickFlash();
   }
 
-  if (digitalRead(BTN_UP) == BTN_ACT) {
+  if (buttonHit(BTN_UP)) {
     earthquakeCursor = (earthquakeCursor - 1 + earthquakeCount) % earthquakeCount;
     selectedEarthquake = earthquakes[earthquakeCursor];
     ledQuickFlash();
@@ -10229,19 +13086,19 @@ void handleEarthquakeMapInput() {
 }
 
 void handleEarthquakeSettingsInput() {
-  if (digitalRead(BTN_LEFT) == BTN_ACT && digitalRead(BTN_RIGHT) == BTN_ACT) return;
+  if (buttonHeld(BTN_LEFT) && buttonHeld(BTN_RIGHT)) return;
 
-  if (digitalRead(BTN_DOWN) == BTN_ACT) {
+  if (buttonHit(BTN_DOWN)) {
     eqSettingsCursor = (eqSettingsCursor + 1) % eqSettingsCount;
     ledQuickFlash();
   }
 
-  if (digitalRead(BTN_UP) == BTN_ACT) {
+  if (buttonHit(BTN_UP)) {
     eqSettingsCursor = (eqSettingsCursor - 1 + eqSettingsCount) % eqSettingsCount;
     ledQuickFlash();
   }
 
-  if (digitalRead(BTN_SELECT) == BTN_ACT) {
+  if (buttonHit(BTN_SELECT)) {
     ledSuccess();
     switch (eqSettingsCursor) {
       case 0: // Min Magnitude - cycle through 0, 2.5, 4.5, 6.0
@@ -10371,6 +13228,7 @@ void handleMainMenuSelect() {
       if (WiFi.status() == WL_CONNECTED) {
         isSelectingMode = true;
         showAIModeSelection(0);
+        pushCanvas();
       } else {
         ledError();
         showStatus("WiFi not connected!", 1500);
@@ -10471,8 +13329,6 @@ void drawSystemInfoMenu() {
 
   const char* items[] = {"Device Info", "Wi-Fi Info", "Storage Info", "Back"};
   drawScrollableMenu(items, 4, 45, 30, 5);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void handleSystemInfoMenuInput() {
@@ -10538,6 +13394,15 @@ void handleRacingModeSelect() {
       break;
     case 1: // 2 Player
       raceGameMode = RACE_MODE_MULTI;
+      opponentPresent = false;
+      {
+        uint32_t seed = esp_random();
+        portENTER_CRITICAL(&raceSyncMux);
+        raceSyncReset(raceSync);
+        raceSync.trackSeed = seed;
+        portEXIT_CRITICAL(&raceSyncMux);
+        rngSeed(rngTrack, seed);
+      }
       generateTrack();
       racingGameActive = true;
       changeState(STATE_GAME_RACING);
@@ -10846,16 +13711,28 @@ void drawLocalAiChat();
 void refreshCurrentScreen() {
   if (isSelectingMode) {
     showAIModeSelection(0);
+    pushCanvas();
     return;
   }
   
-  int x_offset = 0;
-  if (transitionState == TRANSITION_OUT) {
-    x_offset = -SCREEN_WIDTH * transitionProgress;
-  } else if (transitionState == TRANSITION_IN) {
-    x_offset = SCREEN_WIDTH * (1.0 - transitionProgress);
+  profSetState(currentState);
+  PROF_SCOPE(PROF_FRAME);
+  if (transitionState != TRANSITION_NONE) {
+    renderTransitionFrame();
+  } else {
+    drawCurrentScreen();
   }
-  
+  if (showProfiler) drawProfilerOverlay();
+
+  pushCanvas(frameShakeX, frameShakeY);
+  frameShakeX = 0;
+  frameShakeY = 0;
+}
+
+void drawCurrentScreen() {
+  PROF_SCOPE(PROF_DRAW);
+  int x_offset = 0; // transitions are composited from snapshots instead
+
   switch(currentState) {
     case STATE_BOOT:
       {
@@ -11074,7 +13951,6 @@ void drawGenericToolScreen(const char* title) {
   canvas.print("UI Not Implemented");
   canvas.setTextColor(COLOR_DIM);
   canvas.setCursor(10, SCREEN_HEIGHT - 12);
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void drawSpammer() {
@@ -11257,116 +14133,71 @@ void drawRadioFM() {
       canvas.setCursor(SCREEN_WIDTH/2 - w/2, 160);
       canvas.print(pStr);
   }
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void handleRadioFMInput() {
-  unsigned long currentMillis = millis();
-  if (currentMillis - lastDebounce < 200) return;
-
-  bool btnUp = (digitalRead(BTN_UP) == BTN_ACT);
-  bool btnDown = (digitalRead(BTN_DOWN) == BTN_ACT);
-  bool btnLeft = (digitalRead(BTN_LEFT) == BTN_ACT);
-  bool btnRight = (digitalRead(BTN_RIGHT) == BTN_ACT);
-  bool btnSelect = (digitalRead(BTN_SELECT) == BTN_ACT);
-
-  if (btnLeft && btnRight) {
+  if (buttonCombo(BTN_LEFT, BTN_RIGHT)) {
       saveConfig();
       changeState(STATE_MAIN_MENU);
-      delay(200);
       return;
   }
 
-  if (btnUp && !btnSelect) {
+  // UP/DOWN held with SELECT pick its action instead of changing volume
+  bool btnSelect = buttonHeld(BTN_SELECT);
+  if (buttonHit(BTN_UP) && !btnSelect) {
     if (radioVolume < 15) {
       radioVolume++;
       radio.setVolume(radioVolume);
       ledQuickFlash();
     }
-    lastDebounce = currentMillis;
   }
-  if (btnDown && !btnSelect) {
+  if (buttonHit(BTN_DOWN) && !btnSelect) {
     if (radioVolume > 0) {
       radioVolume--;
       radio.setVolume(radioVolume);
       ledQuickFlash();
     }
-    lastDebounce = currentMillis;
-  }
-
-  if (btnLeft) {
-    unsigned long start = millis();
-    while(digitalRead(BTN_LEFT) == BTN_ACT) {
-      if (millis() - start > 800) {
-        isRadioSeeking = true;
-        drawRadioFM();
-        radio.seekDown(true);
-        delay(300);
-        radioFrequency = radio.getFrequency();
-        radioRDS = ""; radioRT = ""; radioSelectedPreset = -1;
-        rds.init();
-        isRadioSeeking = false;
-        ledSuccess();
-        lastDebounce = millis();
-        return;
-      }
-      delay(10);
-    }
-    radioFrequency -= 10;
-    if (radioFrequency < 8700) radioFrequency = 10800;
-                if (radioFrequency < 8700 || radioFrequency > 10850) radioFrequency = 10110;
-    radio.setFrequency(radioFrequency);
+  }
+
+  if (buttonLong(BTN_LEFT) || buttonLong(BTN_RIGHT)) {
+    isRadioSeeking = true;
+    drawRadioFM();
+    pushCanvas();
+    if (buttonLong(BTN_LEFT)) radio.seekDown(true);
+    else radio.seekUp(true);
+    delay(300);
+    radioFrequency = radio.getFrequency();
     radioRDS = ""; radioRT = ""; radioSelectedPreset = -1;
     rds.init();
-    ledQuickFlash();
-    lastDebounce = millis();
-  }
-
-  if (btnRight) {
-    unsigned long start = millis();
-    while(digitalRead(BTN_RIGHT) == BTN_ACT) {
-      if (millis() - start > 800) {
-        isRadioSeeking = true;
-        drawRadioFM();
-        radio.seekUp(true);
-        delay(300);
-        radioFrequency = radio.getFrequency();
-        radioRDS = ""; radioRT = ""; radioSelectedPreset = -1;
-        rds.init();
-        isRadioSeeking = false;
-        ledSuccess();
-        lastDebounce = millis();
-        return;
-      }
-      delay(10);
+    isRadioSeeking = false;
+    ledSuccess();
+  }
+
+  if (buttonShort(BTN_LEFT) || buttonShort(BTN_RIGHT)) {
+    if (buttonShort(BTN_LEFT)) {
+      radioFrequency -= 10;
+      if (radioFrequency < 8700) radioFrequency = 10800;
+    } else {
+      radioFrequency += 10;
+      if (radioFrequency > 10800) radioFrequency = 8700;
     }
-    radioFrequency += 10;
-    if (radioFrequency > 10800) radioFrequency = 8700;
                 if (radioFrequency < 8700 || radioFrequency > 10850) radioFrequency = 10110;
     radio.setFrequency(radioFrequency);
     radioRDS = ""; radioRT = ""; radioSelectedPreset = -1;
     rds.init();
     ledQuickFlash();
-    lastDebounce = millis();
   }
 
-  if (btnSelect) {
-    unsigned long start = millis();
-    while(digitalRead(BTN_SELECT) == BTN_ACT) {
-      if (millis() - start > 1500) {
-        radioScan();
-        lastDebounce = millis();
-        return;
-      }
-      delay(10);
-    }
+  if (buttonLong(BTN_SELECT)) {
+    radioScan();
+  }
 
-    if (digitalRead(BTN_UP) == BTN_ACT) {
+  if (buttonShort(BTN_SELECT)) {
+    if (buttonHeld(BTN_UP)) {
       radioBassBoost = !radioBassBoost;
       radio.setBassBoost(radioBassBoost);
       showStatus(radioBassBoost ? "Bass ON" : "Bass OFF", 1000);
-    } else if (digitalRead(BTN_DOWN) == BTN_ACT) {
+    } else if (buttonHeld(BTN_DOWN)) {
       radioMute = !radioMute;
       radio.setMute(radioMute);
       showStatus(radioMute ? "Muted" : "Unmuted", 1000);
@@ -11380,7 +14211,6 @@ void handleRadioFMInput() {
       showStatus(radioPresets[radioSelectedPreset].name, 1000);
     }
     ledQuickFlash();
-    lastDebounce = millis();
   }
 }
 
@@ -11395,6 +14225,7 @@ void radioScan() {
     delay(500);
     radioFrequency = radio.getFrequency();
     drawRadioFM();
+    pushCanvas();
   }
 
   isRadioScanning = false;
@@ -11405,7 +14236,18 @@ void updateRadioRDS() {
   radio.checkRDS();
 }
 void drawFileViewer() {
-  canvas.fillScreen(COLOR_BG);
+  static TextLayout fileLayout;
+  static ScrollViewport fileViewport;
+  int32_t originY = 45 - fileViewerScrollOffset;
+  textLayoutSync(fileLayout, fileContentToView, textVersion, 1, SCREEN_WIDTH - 15, 10, true, SCREEN_HEIGHT - originY);
+
+  int16_t y0, y1;
+  scrollViewportBegin(fileViewport, 40, SCREEN_HEIGHT, fileViewerScrollOffset,
+                      fileLayout.version ^ fileLayout.length, COLOR_BG, y0, y1);
+  if (y1 > y0) textLayoutDraw(fileLayout, fileContentToView, 5, originY, y0, y1, COLOR_TEXT);
+  scrollViewportEnd(fileViewport);
+
+  canvas.fillRect(0, 0, SCREEN_WIDTH, 40, COLOR_BG);
   drawStatusBar();
 
   canvas.fillRect(0, 15, SCREEN_WIDTH, 20, 0x7BEF); // Gray/Blue
@@ -11414,41 +14256,7 @@ void drawFileViewer() {
   canvas.setCursor(10, 18);
   canvas.print("File Viewer");
 
-  canvas.setTextSize(1);
-  canvas.setTextColor(COLOR_TEXT);
-  int y = 45 - fileViewerScrollOffset;
-  int lineHeight = 10;
-  String word = "";
-  int x = 5;
-  for (unsigned int i = 0; i < fileContentToView.length(); i++) {
-    char c = fileContentToView.charAt(i);
-    if (c == ' ' || c == '\n' || i == fileContentToView.length() - 1) {
-      if (i == fileContentToView.length() - 1 && c != ' ' && c != '\n') {
-        word += c;
-      }
-      int wordWidth = word.length() * 6;
-      if (x + wordWidth > SCREEN_WIDTH - 10) {
-        y += lineHeight;
-        x = 5;
-      }
-      if (y >= 40 && y < SCREEN_HEIGHT - 5) {
-        canvas.setCursor(x, y);
-        canvas.print(word);
-      }
-      x += wordWidth + 6;
-      word = "";
-      if (c == '\n') {
-        y += lineHeight;
-        x = 5;
-      }
-    } else {
-      word += c;
-    }
-  }
-
   canvas.setTextColor(COLOR_DIM);
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 
@@ -11636,6 +14444,7 @@ void setup() {
     pinMode(BTN_LEFT, INPUT);
     pinMode(BTN_RIGHT, INPUT);
     pinMode(BTN_BACK, INPUT);
+    initButtonEvents();
     pinMode(BATTERY_PIN, INPUT);
     analogSetPinAttenuation(BATTERY_PIN, ADC_11db);
     pinMode(DFPLAYER_BUSY_PIN, INPUT_PULLUP);
@@ -11644,6 +14453,21 @@ void setup() {
     tft.init(170, 320);
     tft.setRotation(3);
     canvas.setTextWrap(false);
+    profReset();
+    rngSeedAll(esp_random());
+    initDisplayPipeline();
+    #ifdef PIXEL_KERNEL_BENCH
+    runPixelKernelBenchmark();
+    #endif
+    #ifdef FIXED_MATH_BENCH
+    runFixedMathBenchmark();
+    #endif
+    #ifdef PARTICLE_BENCH
+    runParticleBenchmark();
+    #endif
+    #ifdef RACE_SYNC_LOOPBACK_TEST
+    runRaceSyncLoopbackTest();
+    #endif
     ledcWrite(LEDC_BACKLIGHT_CTRL, 255); // Default brightness
 
     // --- Init Pixels ---
@@ -11661,7 +14485,7 @@ void setup() {
     const char* linesPtr[maxBootLines];
     for (int i = 0; i < bootStatusCount; i++) linesPtr[i] = bootStatusLines[i].c_str();
     drawBootScreen(linesPtr, bootStatusCount, bootProgress);
-    tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
+    pushCanvas();
 
     // Set state to start phased initialization
     currentState = STATE_BOOT;
@@ -11691,6 +14515,266 @@ void updateMusicPlayerState() {
     }
 }
 
+// ============ FRAME SCHEDULER ============
+// Each state declares how fast it may render and what invalidates it. A frame
+// is drawn only when some source is pending and the state's frame interval has
+// elapsed, so static screens sit idle between inputs and data updates while
+// games keep rendering every frame.
+struct StatePacing {
+  AppState state;
+  uint8_t fps;        // frame cap for this state
+  uint16_t tickMs;    // periodic INVAL_TIMER, 0 = none
+  bool continuous;    // always animating (games, visualizers)
+};
+
+const StatePacing statePacing[] = {
+  {STATE_BOOT,                30,         0,   true},
+  {STATE_MAIN_MENU,           TARGET_FPS, 33,  false},  // tick drives the selection pulse
+  {STATE_EARTHQUAKE,          30,         0,   true},   // ticker text
+  {STATE_LOADING,             TARGET_FPS, 100, false},  // loadingFrame steps every 100 ms
+  {STATE_VIS_STARFIELD,       TARGET_FPS, 0,   true},
+  {STATE_VIS_LIFE,            TARGET_FPS, 0,   true},
+  {STATE_VIS_FIRE,            TARGET_FPS, 0,   true},
+  {STATE_GAME_PONG,           TARGET_FPS, 0,   true},
+  {STATE_GAME_SNAKE,          TARGET_FPS, 0,   true},
+  {STATE_GAME_FLAPPY,         TARGET_FPS, 0,   true},
+  {STATE_GAME_BREAKOUT,       TARGET_FPS, 0,   true},
+  {STATE_GAME_RACING,         TARGET_FPS, 0,   true},
+  {STATE_GAME_PLATFORMER,     TARGET_FPS, 0,   true},
+  {STATE_RADIO_FM,            30,         0,   true},
+  {STATE_TOOL_SNIFFER,        30,         0,   true},
+  {STATE_TOOL_WIFI_SONAR,     30,         0,   true},
+  {STATE_TOOL_DEAUTH_ATTACK,  30,         0,   true},
+  {STATE_MUSIC_PLAYER,        30,         0,   true},   // visualizer
+  {STATE_EARTHQUAKE_MAP,      30,         0,   true},
+  {STATE_WIKI_VIEWER,         TARGET_FPS, 250, false},  // loading indicator
+  {STATE_SYSTEM_MONITOR,      TARGET_FPS, 100, false},
+  {STATE_SCREENSAVER,         30,         33,  false},
+};
+const StatePacing defaultPacing = {STATE_MAIN_MENU, TARGET_FPS, 0, false};
+
+const StatePacing& getStatePacing(AppState state) {
+  for (size_t i = 0; i < sizeof(statePacing) / sizeof(statePacing[0]); i++) {
+    if (statePacing[i].state == state) return statePacing[i];
+  }
+  return defaultPacing;
+}
+
+// True while the current state has motion that hasn't settled yet
+bool stateAnimating() {
+  return transitionState != TRANSITION_NONE || emergencyActive || animationsActive();
+}
+
+// Pomodoro only needs a frame when the displayed second changes
+void watchPomodoroData() {
+  static long lastShown = -1;
+  long remaining;
+  if (pomoState == POMO_IDLE) remaining = -2;
+  else if (pomoIsPaused) remaining = pomoPauseRemaining / 1000;
+  else remaining = pomoEndTime > millis() ? (pomoEndTime - millis()) / 1000 : 0;
+  if (remaining != lastShown) {
+    lastShown = remaining;
+    invalidateScreen(INVAL_DATA);
+  }
+}
+
+// Collect invalidation for this loop and render if a frame is due
+void scheduleFrame(unsigned long now) {
+  static unsigned long lastTick = 0;
+  static unsigned long lastFpsTick = 0;
+  static AppState lastState = STATE_BOOT;
+  const StatePacing& pace = getStatePacing(currentState);
+
+  if (currentState != lastState) {
+    lastState = currentState;
+    qualityGovernorReset(1000000UL / pace.fps);
+    invalidateScreen(INVAL_DATA);
+  }
+  if (screenIsDirty) {
+    screenIsDirty = false;
+    invalidateScreen(INVAL_DATA);
+  }
+  if (pace.continuous || stateAnimating()) {
+    invalidateScreen(INVAL_ANIM);
+  }
+  if (pace.tickMs > 0 && now - lastTick >= pace.tickMs) {
+    lastTick = now;
+    invalidateScreen(INVAL_TIMER);
+  }
+  if ((showFPS || showProfiler) && now - lastFpsTick >= 1000) {
+    lastFpsTick = now;
+    invalidateScreen(INVAL_TIMER);
+  }
+
+  if (pendingInvalidation == 0) return;
+  // Transitions are cheap composites, so they always run at full rate
+  uint8_t fps = (transitionState != TRANSITION_NONE) ? TARGET_FPS : pace.fps;
+  if (now - lastUiUpdate < 1000UL / fps) return;
+  lastUiUpdate = now;
+  pendingInvalidation = 0;
+  perfFrameCount++;
+
+  // Only back-to-back frames of continuous screens say anything about load
+  static uint32_t lastGovernedStart = 0;
+  bool governed = pace.continuous && transitionState == TRANSITION_NONE;
+  uint32_t startUs = micros();
+  refreshCurrentScreen();
+  replayFrame(startUs, micros() - startUs);
+  if (governed) {
+    uint32_t intervalUs = startUs - lastGovernedStart;
+    if (lastGovernedStart != 0 && intervalUs < 4 * qualityGov.budgetUs) {
+      qualityGovernorFrame(intervalUs, micros() - startUs);
+    }
+    lastGovernedStart = startUs;
+  } else {
+    lastGovernedStart = 0;
+  }
+}
+
+#ifdef RENDER_BENCH
+// ============ RENDER BENCHMARK ============
+// Drives drawCurrentScreen() for a set of screens with canned state and
+// reports per-screen render time over Serial: the first (cold) frame, then
+// min/avg/max over RENDER_BENCH_FRAMES warm frames. Nothing is pushed to the
+// panel. With an SD card each screen's last frame is saved as
+// /bench/<name>.bmp so renders can be compared between builds.
+#define RENDER_BENCH_FRAMES 30
+#define RENDER_BENCH_SEED 0x5EED2024u
+
+const char* benchSampleText =
+  "The quick brown fox jumps over the lazy dog. Pack my box with five dozen liquor jugs.\n"
+  "Sphinx of black quartz, judge my vow. How vexingly quick daft zebras jump!\n\n";
+
+void saveCanvasBMP(const char* path) {
+  File f = SD.open(path, FILE_WRITE);
+  if (!f) return;
+
+  const uint32_t rowBytes = SCREEN_WIDTH * 3;  // 960, already 4-byte aligned
+  const uint32_t imageBytes = rowBytes * SCREEN_HEIGHT;
+  uint8_t header[54] = {'B', 'M'};
+  auto put32 = [&](int at, uint32_t v) {
+    header[at] = v; header[at + 1] = v >> 8; header[at + 2] = v >> 16; header[at + 3] = v >> 24;
+  };
+  put32(2, 54 + imageBytes);
+  put32(10, 54);
+  put32(14, 40);
+  put32(18, SCREEN_WIDTH);
+  put32(22, (uint32_t)-SCREEN_HEIGHT);  // top-down
+  header[26] = 1;
+  header[28] = 24;
+  put32(34, imageBytes);
+  f.write(header, sizeof(header));
+
+  static uint8_t row[SCREEN_WIDTH * 3];
+  const uint16_t* buf = canvas.getBuffer();
+  for (int y = 0; y < SCREEN_HEIGHT; y++) {
+    for (int x = 0; x < SCREEN_WIDTH; x++) {
+      uint16_t c = buf[y * SCREEN_WIDTH + x];
+      row[x * 3]     = (c & 0x1F) << 3;          // B
+      row[x * 3 + 1] = ((c >> 5) & 0x3F) << 2;   // G
+      row[x * 3 + 2] = (c >> 11) << 3;           // R
+    }
+    f.write(row, rowBytes);
+  }
+  f.close();
+}
+
+void benchScreen(const char* name, AppState state) {
+  currentState = state;
+  unsigned long t0 = micros();
+  drawCurrentScreen();
+  unsigned long cold = micros() - t0;
+
+  unsigned long minT = ~0UL, maxT = 0, total = 0;
+  for (int i = 0; i < RENDER_BENCH_FRAMES; i++) {
+    t0 = micros();
+    drawCurrentScreen();
+    unsigned long t = micros() - t0;
+    total += t;
+    if (t < minT) minT = t;
+    if (t > maxT) maxT = t;
+    yield();
+  }
+  Serial.printf("[bench] %-14s cold %6lu us  min %6lu  avg %6lu  max %6lu us\n",
+                name, cold, minT, total / RENDER_BENCH_FRAMES, maxT);
+
+  if (sdCardMounted) {
+    char path[40];
+    snprintf(path, sizeof(path), "/bench/%s.bmp", name);
+    saveCanvasBMP(path);
+  }
+}
+
+void runRenderBenchmark() {
+  Serial.println(F("[bench] Render benchmark"));
+  if (sdCardMounted && !SD.exists("/bench")) SD.mkdir("/bench");
+  rngSeedAll(RENDER_BENCH_SEED);  // Same particles and track on every run
+
+  AppState savedState = currentState;
+  int savedSelection = menuSelection;
+  float savedScroll = animValue(menuScrollAnim);
+  String savedResponse = aiResponse;
+  String savedFile = fileContentToView;
+  WikiArticle savedArticle = currentArticle;
+  Earthquake savedQuake = selectedEarthquake;
+  frameShakeX = 0;
+  frameShakeY = 0;
+
+  menuSelection = 3;
+  animSnap(menuScrollAnim, 3 * 85);
+  benchScreen("main_menu", STATE_MAIN_MENU);
+  animSnap(menuScrollAnim, 3 * 85 - 40);  // mid-scroll
+  benchScreen("main_menu_scroll", STATE_MAIN_MENU);
+
+  raceGameMode = RACE_MODE_SINGLE;
+  generateTrack();
+  racingGameActive = true;
+  playerCar = {0, 0, 1500, 120, 0, 0};
+  benchScreen("racing", STATE_GAME_RACING);
+  racingGameActive = false;  // reset on next entry
+
+  benchScreen("music_player", STATE_MUSIC_PLAYER);
+
+  selectedEarthquake.isValid = true;
+  selectedEarthquake.magnitude = 6.1;
+  selectedEarthquake.latitude = -7.8;
+  selectedEarthquake.longitude = 110.4;
+  selectedEarthquake.depth = 10;
+  selectedEarthquake.place = "Bench, Java";
+  benchScreen("earthquake_map", STATE_EARTHQUAKE_MAP);
+
+  String longText;
+  for (int i = 0; i < 32; i++) longText += benchSampleText;  // ~5 KB
+  aiResponse = longText;
+  textVersion++;
+  scrollOffset = 0;
+  benchScreen("chat_response", STATE_CHAT_RESPONSE);
+  fileContentToView = longText;
+  textVersion++;
+  fileViewerScrollOffset = 2000;
+  benchScreen("file_viewer", STATE_FILE_VIEWER);
+  currentArticle.title = "Benchmark Article With A Title Long Enough To Wrap";
+  currentArticle.extract = longText;
+  textVersion++;
+  wikiScrollOffset = 0;
+  benchScreen("wiki_viewer", STATE_WIKI_VIEWER);
+
+  fileViewerScrollOffset = 0;
+  currentArticle = savedArticle;
+  fileContentToView = savedFile;
+  aiResponse = savedResponse;
+  textVersion++;
+  selectedEarthquake = savedQuake;
+  animSnap(menuScrollAnim, savedScroll);
+  menuSelection = savedSelection;
+  currentState = savedState;
+  frameShakeX = 0;
+  frameShakeY = 0;
+  rngSeedAll(esp_random());
+  invalidateScreen(INVAL_DATA);
+}
+#endif
+
 // ============ LOOP ============
 void loop() {
   updateLateInit();
@@ -11699,13 +14783,30 @@ void loop() {
     Serial.println(F("=== MAIN LOOP STARTED ==="));
     firstLoop = false;
   }
+  #ifdef RENDER_BENCH
+  static bool renderBenchDone = false;
+  if (lateInitDone && !renderBenchDone) {
+    renderBenchDone = true;
+    runRenderBenchmark();
+  }
+  #endif
+  restoreCanvasHeap();
+  handleSerialCommands();
+  #if FRAME_PROFILER
+  profSetState(currentState);
+  #endif
   unsigned long currentMillis = millis();
+  bool buttonEvents = pollButtonEvents();
+  if (buttonEvents) lastInputTime = currentMillis;
   perfLoopCount++;
   if (currentMillis - perfLastTime >= 1000) {
     perfFPS = perfFrameCount;
     perfLPS = perfLoopCount;
+    perfBytesPerFrame = perfPushCount > 0 ? perfPushBytes / perfPushCount : 0;
     perfFrameCount = 0;
     perfLoopCount = 0;
+    perfPushBytes = 0;
+    perfPushCount = 0;
     perfLastTime = currentMillis;
   }
 
@@ -11718,81 +14819,17 @@ void loop() {
   float dt = deltaTime;
 
   // Animation Logic
-  if (currentState == STATE_MAIN_MENU) {
-      int itemGap = 85; // Sesuaikan dengan celah menu baru
-      menuScrollTarget = menuSelection * itemGap;
-
-      // Fisika pegas untuk scrolling yang lebih alami
-      float spring = 0.4f; // Kekakuan pegas
-      float damp = 0.6f;  // Redaman
-
-      float diff = menuScrollTarget - menuScrollCurrent;
-      float force = diff * spring;
-      menuVelocity += force;
-      menuVelocity *= damp;
-
-      if (abs(diff) < 0.5f && abs(menuVelocity) < 0.5f) {
-          menuScrollCurrent = menuScrollTarget;
-          menuVelocity = 0.0f;
-      } else {
-          menuScrollCurrent += menuVelocity * dt * 50.0f; // Kalikan dengan dt dan skalar
-      }
-  }
-
-  if (currentState == STATE_PRAYER_SETTINGS) {
-      float spring = 0.3f; // Softer spring
-      float damp = 0.7f;   // More dampening
-      float target = prayerSettingsCursor * 18.0f; // Matching new item height
-      float diff = target - prayerSettingsScroll;
-      prayerSettingsVelocity += diff * spring;
-      prayerSettingsVelocity *= damp;
-      if (abs(diff) < 0.1f && abs(prayerSettingsVelocity) < 0.1f) {
-          prayerSettingsScroll = target;
-          prayerSettingsVelocity = 0.0f;
-      } else {
-          prayerSettingsScroll += prayerSettingsVelocity * dt * 50.0f;
-      }
-  }
-
-  if (currentState == STATE_PRAYER_CITY_SELECT) {
-      float spring = 0.3f;
-      float damp = 0.7f;
-      float target = citySelectCursor * 18.0f;
-      float diff = target - citySelectScroll;
-      citySelectVelocity += diff * spring;
-      citySelectVelocity *= damp;
-      if (abs(diff) < 0.1f && abs(citySelectVelocity) < 0.1f) {
-          citySelectScroll = target;
-          citySelectVelocity = 0.0f;
-      } else {
-          citySelectScroll += citySelectVelocity * dt * 50.0f;
-      }
-  }
-
-  if (currentState == STATE_ESPNOW_CHAT && chatAnimProgress < 1.0f) {
-      chatAnimProgress += 2.0f * dt; // Fast animation
-      if (chatAnimProgress > 1.0f) chatAnimProgress = 1.0f;
+  if (chatSlidePending) {
+      chatSlidePending = false;
+      animSnap(chatSlideAnim, 0.0f);
+      animSetTarget(chatSlideAnim, 1.0f);
   }
+  animationsUpdate(dt);
 
   if (currentState == STATE_EARTHQUAKE) {
       eqTextScroll += 30.0f * dt; // Scroll speed
   }
 
-  if (currentState == STATE_EARTHQUAKE_SETTINGS) {
-      float spring = 0.3f;
-      float damp = 0.7f;
-      float target = eqSettingsCursor * 16.0f;
-      float diff = target - eqSettingsScroll;
-      eqSettingsVelocity += diff * spring;
-      eqSettingsVelocity *= damp;
-      if (abs(diff) < 0.1f && abs(eqSettingsVelocity) < 0.1f) {
-          eqSettingsScroll = target;
-          eqSettingsVelocity = 0.0f;
-      } else {
-          eqSettingsScroll += eqSettingsVelocity * dt * 50.0f;
-      }
-  }
-
   updateNeoPixel();
   updateBuiltInLED();
   updateStatusBarData();
@@ -11804,130 +14841,60 @@ void loop() {
     }
   }
 
-  // Force redraw for states that are always animating
-  switch (currentState) {
-    case STATE_BOOT:
-    case STATE_MAIN_MENU: // For smooth scrolling
-    case STATE_EARTHQUAKE: // For scrolling text
-    case STATE_EARTHQUAKE_SETTINGS: // For smooth scrolling
-    case STATE_LOADING:
-    case STATE_VIS_STARFIELD:
-    case STATE_VIS_LIFE:
-    case STATE_VIS_FIRE:
-    case STATE_GAME_PONG:
-    case STATE_GAME_SNAKE:
-    case STATE_GAME_FLAPPY:
-    case STATE_GAME_BREAKOUT:
-    case STATE_GAME_RACING:
-    case STATE_RADIO_FM:
-    case STATE_TOOL_SNIFFER:
-    case STATE_TOOL_WIFI_SONAR:
-    case STATE_TOOL_DEAUTH_ATTACK:
-    case STATE_MUSIC_PLAYER: // For visualizer
-    case STATE_WIKI_VIEWER:
-    case STATE_SYSTEM_MONITOR:
-    case STATE_PRAYER_SETTINGS:
-    case STATE_PRAYER_CITY_SELECT:
-    case STATE_EARTHQUAKE_MAP:
-    // case STATE_SCREENSAVER: // For blinking colon and starfield
-      screenIsDirty = true;
-      break;
-    default:
-      break;
-  }
-
-  // Also set dirty flag during screen transitions or other specific animations
-  if (transitionState != TRANSITION_NONE ||
-     (currentState == STATE_ESPNOW_CHAT && chatAnimProgress < 1.0f) ||
-     emergencyActive) {
-    screenIsDirty = true;
-  }
-  
-  if (transitionState != TRANSITION_NONE) {
+  // Transition ends in renderTransitionFrame once the last frame is composed
+  if (transitionState == TRANSITION_IN) {
     transitionProgress += transitionSpeed * dt;
-    if (transitionProgress >= 1.0f) {
-      transitionProgress = 1.0f;
-      if (transitionState == TRANSITION_OUT) {
-        currentState = transitionTargetState;
-        transitionState = TRANSITION_IN;
-        transitionProgress = 0.0f;
-      } else {
-        transitionState = TRANSITION_NONE;
-      }
-    }
+    if (transitionProgress > 1.0f) transitionProgress = 1.0f;
   }
   
-  if (currentMillis - lastUiUpdate > uiFrameDelay) {
-    lastUiUpdate = currentMillis;
-    if (screenIsDirty) {
-      perfFrameCount++;
-      refreshCurrentScreen();
-      screenIsDirty = false;
-    }
-  }
+  scheduleFrame(currentMillis);
   
   // Attack loop needs to run outside of throttled UI updates
   if (currentState == STATE_TOOL_DEAUTH_ATTACK) {
     updateDeauthAttack();
   }
 
-  if (currentState == STATE_GAME_PONG) {
-    updatePongLogic();
-  }
-
-  if (currentState == STATE_GAME_RACING) {
-    updateRacingLogic();
-  }
-
-  if (currentState == STATE_GAME_SNAKE) {
-    updateSnakeLogic();
-  }
-
-  if (currentState == STATE_GAME_PLATFORMER) {
-    updatePlatformerLogic();
-  }
-
-  if (currentState == STATE_GAME_FLAPPY) {
-    updateFlappyLogic();
-  }
-
-  if (currentState == STATE_GAME_BREAKOUT) {
-    updateBreakoutLogic();
+  // Arcade games step on the fixed timestep; the clock restarts with each game
+  static AppState simState = STATE_BOOT;
+  void (*gameStep)() = nullptr;
+  switch (currentState) {
+    case STATE_GAME_PONG:       gameStep = updatePongLogic; break;
+    case STATE_GAME_RACING:     gameStep = updateRacingLogic; break;
+    case STATE_GAME_SNAKE:      gameStep = updateSnakeLogic; break;
+    case STATE_GAME_PLATFORMER: gameStep = updatePlatformerLogic; break;
+    case STATE_GAME_FLAPPY:     gameStep = updateFlappyLogic; break;
+    case STATE_GAME_BREAKOUT:   gameStep = updateBreakoutLogic; break;
+    default: break;
+  }
+  if (currentState != simState) {
+    simState = currentState;
+    // Before the reset, so a recording that ends here fingerprints its last tick count
+    if (gameStep || replay.mode == REPLAY_RECORDING || replay.mode == REPLAY_PLAYING) replayGameStarted(currentState);
+    simReset();
+  }
+  if (gameStep) {
+    PROF_SCOPE(PROF_LOGIC);
+    simRun(gameStep, micros());
+  }
+
+  // Screens that handle their own input
+  switch (currentState) {
+    case STATE_PRAYER_TIMES:         handlePrayerTimesInput(); break;
+    case STATE_PRAYER_SETTINGS:      handlePrayerSettingsInput(); break;
+    case STATE_PRAYER_CITY_SELECT:   handleCitySelectInput(); break;
+    case STATE_EARTHQUAKE:           handleEarthquakeInput(); break;
+    case STATE_EARTHQUAKE_DETAIL:    handleEarthquakeDetailInput(); break;
+    case STATE_EARTHQUAKE_SETTINGS:  handleEarthquakeSettingsInput(); break;
+    case STATE_EARTHQUAKE_MAP:       handleEarthquakeMapInput(); break;
+    case STATE_UTTT:                 handleUTTTInput(); break;
+    case STATE_UTTT_MENU:            handleUTTTMenuInput(); break;
+    case STATE_UTTT_GAMEOVER:        handleUTTTGameOverInput(); break;
+    case STATE_QUIZ_MENU:            handleQuizMenuInput(); break;
+    case STATE_QUIZ_PLAYING:         handleQuizPlayingInput(); break;
+    case STATE_QUIZ_RESULT:          handleQuizResultInput(); break;
+    case STATE_QUIZ_LEADERBOARD:     handleQuizLeaderboardInput(); break;
+    default: break;
   }
-    else if (currentState == STATE_PRAYER_TIMES) {
-      handlePrayerTimesInput();
-    }
-    else if (currentState == STATE_PRAYER_SETTINGS) {
-      handlePrayerSettingsInput();
-    }
-    else if (currentState == STATE_PRAYER_CITY_SELECT) {
-      handleCitySelectInput();
-    }
-    else if (currentState == STATE_EARTHQUAKE) {
-      handleEarthquakeInput();
-    }
-    else if (currentState == STATE_EARTHQUAKE_DETAIL) {
-      handleEarthquakeDetailInput();
-    }
-    else if (currentState == STATE_EARTHQUAKE_SETTINGS) {
-      handleEarthquakeSettingsInput();
-    }
-    else if (currentState == STATE_UTTT) {
-      handleUTTTInput();
-    }
-    else if (currentState == STATE_UTTT_MENU) {
-      handleUTTTMenuInput();
-    }
-    else if (currentState == STATE_UTTT_GAMEOVER) {
-      handleUTTTGameOverInput();
-    }
-    else if (currentState == STATE_QUIZ_MENU) { handleQuizMenuInput(); }
-    else if (currentState == STATE_QUIZ_PLAYING) { handleQuizPlayingInput(); }
-    else if (currentState == STATE_QUIZ_RESULT) { handleQuizResultInput(); }
-    else if (currentState == STATE_QUIZ_LEADERBOARD) { handleQuizLeaderboardInput(); }
-    else if (currentState == STATE_EARTHQUAKE_MAP) {
-      handleEarthquakeMapInput();
-    }
 
   // Backlight smoothing logic
   if (abs(targetBrightness - currentBrightness) > 0.5) {
@@ -11938,16 +14905,9 @@ void loop() {
     ledcWrite(LEDC_BACKLIGHT_CTRL, (int)currentBrightness);
   }
 
-  if (currentState == STATE_SCREENSAVER) {
-    if (currentMillis - lastScreensaverUpdate > 33) { // ~30 FPS
-      screenIsDirty = true;
-      lastScreensaverUpdate = currentMillis;
-    }
-  }
-
   if (currentState == STATE_POMODORO) {
     updatePomodoroLogic();
-    screenIsDirty = true; // Keep the timer updated
+    watchPomodoroData();
   }
 
   // Radio RDS Update
@@ -11978,81 +14938,59 @@ void loop() {
     }
   }
 
-  if (transitionState == TRANSITION_NONE && currentMillis - lastDebounce > debounceDelay) {
+  if (currentState == STATE_MUSIC_PLAYER) {
+    musicIsPlaying = (digitalRead(DFPLAYER_BUSY_PIN) == LOW);
+  }
+
+  if (transitionState == TRANSITION_NONE && buttonEvents) {
     bool buttonPressed = false;
 
     // Check for any button press to exit screensaver
     if (currentState == STATE_SCREENSAVER) {
-      if (digitalRead(BTN_UP) == BTN_ACT || digitalRead(BTN_DOWN) == BTN_ACT ||
-          digitalRead(BTN_LEFT) == BTN_ACT || digitalRead(BTN_RIGHT) == BTN_ACT ||
-          digitalRead(BTN_SELECT) == BTN_ACT) {
+      if (btnPressed) {
         changeState(previousState); // Kembali ke state sebelumnya
-        lastInputTime = currentMillis;
-        lastDebounce = currentMillis;
         ledQuickFlash();
         return; // Skip sisa input handling
       }
     }
 
-    if (currentState == STATE_MUSIC_PLAYER) {
-      musicIsPlaying = (digitalRead(DFPLAYER_BUSY_PIN) == LOW);
-    }
-
+    // Pong paddle and Snake steering are read in their fixed steps
     if (currentState == STATE_GAME_PONG) {
-      float paddleSpeed = 250.0f * dt;
-      if (digitalRead(BTN_UP) == BTN_ACT) {
-        player1.y = max(0.0f, player1.y - paddleSpeed);
-      }
-      if (digitalRead(BTN_DOWN) == BTN_ACT) {
-        player1.y = min(SCREEN_HEIGHT - 40.0f, player1.y + paddleSpeed);
-      }
-      if (digitalRead(BTN_LEFT) == BTN_ACT && digitalRead(BTN_RIGHT) == BTN_ACT) {
+      if (buttonCombo(BTN_LEFT, BTN_RIGHT)) {
         changeState(STATE_GAME_HUB);
       }
     }
 
     if (currentState == STATE_GAME_SNAKE) {
-      if (digitalRead(BTN_UP) == BTN_ACT && snakeDir != SNAKE_DOWN) snakeDir = SNAKE_UP;
-      if (digitalRead(BTN_DOWN) == BTN_ACT && snakeDir != SNAKE_UP) snakeDir = SNAKE_DOWN;
-      if (digitalRead(BTN_LEFT) == BTN_ACT && snakeDir != SNAKE_RIGHT) snakeDir = SNAKE_LEFT;
-      if (digitalRead(BTN_RIGHT) == BTN_ACT && snakeDir != SNAKE_LEFT) snakeDir = SNAKE_RIGHT;
-      if (digitalRead(BTN_LEFT) == BTN_ACT && digitalRead(BTN_RIGHT) == BTN_ACT) {
+      if (buttonCombo(BTN_LEFT, BTN_RIGHT)) {
         changeState(STATE_GAME_HUB);
       }
     }
     else if (currentState == STATE_MUSIC_PLAYER) {
         // --- NOW PLAYING VIEW CONTROLS ---
+        // Short press on release, long press at BTN_LONG_MS
 
-        // BTN_LEFT
-        if (digitalRead(BTN_LEFT) == BTN_ACT) {
-            if (btnLeftPressTime == 0) {
-            btnLeftPressTime = currentMillis;
-            } else if (!btnLeftLongPressTriggered && (currentMillis - btnLeftPressTime > longPressDuration)) {
-            btnLeftLongPressTriggered = true;
-            // LONG PRESS ACTION: Cycle EQ
+        if (buttonShort(BTN_LEFT)) {
+            myDFPlayer.previous();
+            musicIsPlaying = true;
+            forceMusicStateUpdate = true;
+            trackStartTime = millis();
+        }
+        if (buttonLong(BTN_LEFT)) {
+            // Cycle EQ
             musicEQMode = (musicEQMode + 1) % 6;
             myDFPlayer.EQ(musicEQMode);
             showStatus(String("EQ: ") + eqModeNames[musicEQMode], 800);
-            }
-        } else {
-            if (btnLeftPressTime > 0 && !btnLeftLongPressTriggered) {
-            // SHORT PRESS ACTION: Previous Track
-            myDFPlayer.previous();
+        }
+
+        if (buttonShort(BTN_RIGHT)) {
+            myDFPlayer.next();
             musicIsPlaying = true;
             forceMusicStateUpdate = true;
             trackStartTime = millis();
-            }
-            btnLeftPressTime = 0;
-            btnLeftLongPressTriggered = false;
         }
-
-        // BTN_RIGHT
-        if (digitalRead(BTN_RIGHT) == BTN_ACT) {
-            if (btnRightPressTime == 0) {
-            btnRightPressTime = currentMillis;
-            } else if (!btnRightLongPressTriggered && (currentMillis - btnRightPressTime > longPressDuration)) {
-            btnRightLongPressTriggered = true;
-            // LONG PRESS ACTION: Cycle Loop Mode
+        if (buttonLong(BTN_RIGHT)) {
+            // Cycle Loop Mode
             if (musicLoopMode == LOOP_NONE) {
                 musicLoopMode = LOOP_ALL;
                 myDFPlayer.enableLoopAll();
@@ -12066,40 +15004,10 @@ void loop() {
                 myDFPlayer.disableLoop();
                 showStatus("Loop Off", 800);
             }
-            }
-        } else {
-            if (btnRightPressTime > 0 && !btnRightLongPressTriggered) {
-            // SHORT PRESS ACTION: Next Track
-            myDFPlayer.next();
-            musicIsPlaying = true;
-            forceMusicStateUpdate = true;
-            trackStartTime = millis();
-            }
-            btnRightPressTime = 0;
-            btnRightLongPressTriggered = false;
         }
 
-        // BTN_SELECT
-        if (digitalRead(BTN_SELECT) == BTN_ACT) {
-            if (btnSelectPressTime == 0) {
-            btnSelectPressTime = currentMillis;
-            } else if (!btnSelectLongPressTriggered && (currentMillis - btnSelectPressTime > longPressDuration)) {
-            btnSelectLongPressTriggered = true;
-            // LONG PRESS ACTION: Toggle Shuffle
-            musicIsShuffled = !musicIsShuffled;
-            if (musicIsShuffled) {
-                myDFPlayer.randomAll();
-                showStatus("Shuffle On", 800);
-            } else {
-                // Revert to loop all when shuffle is turned off
-                myDFPlayer.enableLoopAll();
-                musicLoopMode = LOOP_ALL;
-                showStatus("Shuffle Off", 800);
-            }
-            }
-        } else {
-            if (btnSelectPressTime > 0 && !btnSelectLongPressTriggered) {
-            // SHORT PRESS ACTION: Play/Pause
+        if (buttonShort(BTN_SELECT)) {
+            // Play/Pause
             if (musicIsPlaying) {
                 myDFPlayer.pause();
                 musicPauseTime = millis();
@@ -12112,121 +15020,99 @@ void loop() {
                 }
             }
             musicIsPlaying = !musicIsPlaying;
+        }
+        if (buttonLong(BTN_SELECT)) {
+            // Toggle Shuffle
+            musicIsShuffled = !musicIsShuffled;
+            if (musicIsShuffled) {
+                myDFPlayer.randomAll();
+                showStatus("Shuffle On", 800);
+            } else {
+                // Revert to loop all when shuffle is turned off
+                myDFPlayer.enableLoopAll();
+                musicLoopMode = LOOP_ALL;
+                showStatus("Shuffle Off", 800);
             }
-            btnSelectPressTime = 0;
-            btnSelectLongPressTriggered = false;
         }
 
-        // Volume controls (non-blocking)
-        if (currentMillis - lastVolumeChangeMillis > 80) {
-            if (digitalRead(BTN_UP) == BTN_ACT) {
-                if (musicVol < 30) {
-                    musicVol++;
-                    myDFPlayer.volume(musicVol);
-                    saveConfig();
-                    lastVolumeChangeMillis = currentMillis;
-                }
-            }
-            if (digitalRead(BTN_DOWN) == BTN_ACT) {
-                if (musicVol > 0) {
-                    musicVol--;
-                    myDFPlayer.volume(musicVol);
-                    saveConfig();
-                    lastVolumeChangeMillis = currentMillis;
-                }
-            }
+        // Volume, auto-repeats while held
+        if (buttonHit(BTN_UP) && musicVol < 30) {
+            musicVol++;
+            myDFPlayer.volume(musicVol);
+            saveConfig();
+        }
+        if (buttonHit(BTN_DOWN) && musicVol > 0) {
+            musicVol--;
+            myDFPlayer.volume(musicVol);
+            saveConfig();
         }
 
         // Exit
-        if (digitalRead(BTN_LEFT) == BTN_ACT && digitalRead(BTN_RIGHT) == BTN_ACT) {
+        if (buttonCombo(BTN_LEFT, BTN_RIGHT)) {
             myDFPlayer.stop();
             musicIsPlaying = false;
             changeState(STATE_MAIN_MENU);
         }
     } else if (currentState == STATE_POMODORO) {
         // --- POMODORO VIEW CONTROLS (with long press) ---
-        // BTN_LEFT
-        if (digitalRead(BTN_LEFT) == BTN_ACT) {
-            if (pomoBtnLeftPressTime == 0) {
-                pomoBtnLeftPressTime = currentMillis;
-            } else if (!pomoBtnLeftLongPressTriggered && (currentMillis - pomoBtnLeftPressTime > longPressDuration)) {
-                pomoBtnLeftLongPressTriggered = true;
-                // LONG PRESS ACTION: Reset Timer
-                pomoState = POMO_IDLE;
-                pomoIsPaused = false;
-                pomoSessionCount = 0;
-                myDFPlayer.stop();
-                showStatus("Timer Reset", 800);
-            }
-        } else {
-            if (pomoBtnLeftPressTime > 0 && !pomoBtnLeftLongPressTriggered) {
-                // SHORT PRESS ACTION: Previous Track
-                if (pomoState == POMO_WORK) myDFPlayer.previous();
-            }
-            pomoBtnLeftPressTime = 0;
-            pomoBtnLeftLongPressTriggered = false;
+        if (buttonShort(BTN_LEFT)) {
+            // Previous Track
+            if (pomoState == POMO_WORK) myDFPlayer.previous();
+        }
+        if (buttonLong(BTN_LEFT)) {
+            // Reset Timer
+            pomoState = POMO_IDLE;
+            pomoIsPaused = false;
+            pomoSessionCount = 0;
+            myDFPlayer.stop();
+            showStatus("Timer Reset", 800);
         }
 
-        // BTN_RIGHT
-        if (digitalRead(BTN_RIGHT) == BTN_ACT) {
-            if (pomoBtnRightPressTime == 0) {
-                pomoBtnRightPressTime = currentMillis;
-            } else if (!pomoBtnRightLongPressTriggered && (currentMillis - pomoBtnRightPressTime > longPressDuration)) {
-                pomoBtnRightLongPressTriggered = true;
-                // LONG PRESS ACTION: Toggle Shuffle
-                pomoMusicShuffle = !pomoMusicShuffle;
-                if (pomoMusicShuffle) {
-                    myDFPlayer.randomAll();
-                    showStatus("Shuffle On", 800);
-                } else {
-                    myDFPlayer.enableLoopAll();
-                    showStatus("Shuffle Off", 800);
-                }
-            }
-        } else {
-            if (pomoBtnRightPressTime > 0 && !pomoBtnRightLongPressTriggered) {
-                // SHORT PRESS ACTION: Next Track
-                if (pomoState == POMO_WORK) myDFPlayer.next();
+        if (buttonShort(BTN_RIGHT)) {
+            // Next Track
+            if (pomoState == POMO_WORK) myDFPlayer.next();
+        }
+        if (buttonLong(BTN_RIGHT)) {
+            // Toggle Shuffle
+            pomoMusicShuffle = !pomoMusicShuffle;
+            if (pomoMusicShuffle) {
+                myDFPlayer.randomAll();
+                showStatus("Shuffle On", 800);
+            } else {
+                myDFPlayer.enableLoopAll();
+                showStatus("Shuffle Off", 800);
             }
-            pomoBtnRightPressTime = 0;
-            pomoBtnRightLongPressTriggered = false;
         }
 
-        // Volume controls (non-blocking)
-        if (currentMillis - lastVolumeChangeMillis > 80) {
-            if (digitalRead(BTN_UP) == BTN_ACT) {
-                if (pomoMusicVol < 30) {
-                    pomoMusicVol++;
-                    myDFPlayer.volume(pomoMusicVol);
-                    lastVolumeChangeMillis = currentMillis;
-                }
-            }
-            if (digitalRead(BTN_DOWN) == BTN_ACT) {
-                if (pomoMusicVol > 0) {
-                    pomoMusicVol--;
-                    myDFPlayer.volume(pomoMusicVol);
-                    lastVolumeChangeMillis = currentMillis;
-                }
-            }
+        // Volume, auto-repeats while held
+        if (buttonHit(BTN_UP) && pomoMusicVol < 30) {
+            pomoMusicVol++;
+            myDFPlayer.volume(pomoMusicVol);
+        }
+        if (buttonHit(BTN_DOWN) && pomoMusicVol > 0) {
+            pomoMusicVol--;
+            myDFPlayer.volume(pomoMusicVol);
         }
     }
     
     if (isSelectingMode) {
-      if (digitalRead(BTN_UP) == BTN_ACT) {
+      if (buttonHit(BTN_UP)) {
         if ((int)currentAIMode > 0) {
           currentAIMode = (AIMode)((int)currentAIMode - 1);
         }
         showAIModeSelection(0);
+        pushCanvas();
         buttonPressed = true;
       }
-      if (digitalRead(BTN_DOWN) == BTN_ACT) {
+      if (buttonHit(BTN_DOWN)) {
         if ((int)currentAIMode < 3) {
           currentAIMode = (AIMode)((int)currentAIMode + 1);
         }
         showAIModeSelection(0);
+        pushCanvas();
         buttonPressed = true;
       }
-      if (digitalRead(BTN_SELECT) == BTN_ACT) {
+      if (buttonHit(BTN_SELECT)) {
         isSelectingMode = false;
         if (currentAIMode == MODE_LOCAL) {
           showStatus("Local AI WIP", 1500);
@@ -12244,20 +15130,18 @@ void loop() {
         }
         buttonPressed = true;
       }
-      if (digitalRead(BTN_LEFT) == BTN_ACT && digitalRead(BTN_RIGHT) == BTN_ACT) {
+      if (buttonCombo(BTN_LEFT, BTN_RIGHT)) {
         isSelectingMode = false;
         buttonPressed = true;
       }
       
       if (buttonPressed) {
-        lastDebounce = currentMillis;
-        lastInputTime = currentMillis;
         ledQuickFlash();
       }
       return;
     }
     
-    if (digitalRead(BTN_UP) == BTN_ACT) {
+    if (buttonHit(BTN_UP)) {
       switch(currentState) {
         case STATE_MUSIC_PLAYER:
           // Volume controls are handled in their own block below to be non-blocking
@@ -12326,7 +15210,7 @@ void loop() {
       buttonPressed = true;
     }
     
-    if (digitalRead(BTN_DOWN) == BTN_ACT) {
+    if (buttonHit(BTN_DOWN)) {
       switch(currentState) {
         case STATE_PIN_LOCK:
         case STATE_CHANGE_PIN:
@@ -12396,7 +15280,7 @@ void loop() {
       buttonPressed = true;
     }
     
-    if (digitalRead(BTN_LEFT) == BTN_ACT) {
+    if (buttonHit(BTN_LEFT)) {
       switch(currentState) {
         case STATE_PIN_LOCK:
         case STATE_CHANGE_PIN:
@@ -12444,7 +15328,7 @@ void loop() {
       buttonPressed = true;
     }
     
-    if (digitalRead(BTN_RIGHT) == BTN_ACT) {
+    if (buttonHit(BTN_RIGHT)) {
       switch(currentState) {
         case STATE_MAIN_MENU:
           if (menuSelection < 18) menuSelection++;
@@ -12477,7 +15361,7 @@ void loop() {
       buttonPressed = true;
     }
     
-    if (digitalRead(BTN_SELECT) == BTN_ACT) {
+    if (buttonHit(BTN_SELECT)) {
       switch(currentState) {
         case STATE_MAIN_MENU:
           handleMainMenuSelect();
@@ -12541,12 +15425,6 @@ void loop() {
         case STATE_GAME_HUB:
           handleGameHubMenuSelect();
           break;
-        case STATE_GAME_PONG:
-          if (!pongRunning) {
-              pongRunning = true;
-              ledSuccess();
-          }
-          break;
         case STATE_TOOL_SNIFFER:
           // Toggle active/passive or just reset stats
           snifferPacketCount = 0;
@@ -12569,6 +15447,7 @@ void loop() {
                   fileContentToView += (char)file.read();
                 }
                 file.close();
+                textVersion++;
                 fileViewerScrollOffset = 0;
                 changeState(STATE_FILE_VIEWER);
               } else {
@@ -12655,29 +15534,24 @@ void loop() {
           currentKeyboardMode = MODE_LOWER;
           changeState(STATE_KEYBOARD);
           break;
-        case STATE_WIKI_VIEWER:
-          if (btnSelectPressTime == 0) {
-            btnSelectPressTime = currentMillis;
-          } else if (!btnSelectLongPressTriggered && (currentMillis - btnSelectPressTime > longPressDuration)) {
-            btnSelectLongPressTriggered = true;
-            saveWikiBookmark();
-          }
-          break;
         default: break;
       }
+      buttonPressed = true;
+    }
 
-      // Special handling for Wikipedia Select release
-      if (currentState == STATE_WIKI_VIEWER && digitalRead(BTN_SELECT) != BTN_ACT) {
-        if (btnSelectPressTime > 0 && !btnSelectLongPressTriggered) {
-          fetchRandomWiki();
-        }
-        btnSelectPressTime = 0;
-        btnSelectLongPressTriggered = false;
+    // Wikipedia: short press loads another article, long press bookmarks this one
+    if (currentState == STATE_WIKI_VIEWER) {
+      if (buttonShort(BTN_SELECT)) {
+        fetchRandomWiki();
+        buttonPressed = true;
+      }
+      if (buttonLong(BTN_SELECT)) {
+        saveWikiBookmark();
+        buttonPressed = true;
       }
-      buttonPressed = true;
     }
     
-    if (digitalRead(BTN_LEFT) == BTN_ACT && digitalRead(BTN_RIGHT) == BTN_ACT) {
+    if (buttonCombo(BTN_LEFT, BTN_RIGHT)) {
       if (currentState == STATE_PIN_LOCK) {
         // Do nothing to prevent bypassing PIN
       } else if (currentState == STATE_POMODORO) {
@@ -12782,9 +15656,7 @@ void loop() {
    }
     
     if (buttonPressed) {
-      screenIsDirty = true;
-      lastDebounce = currentMillis;
-      lastInputTime = currentMillis;
+      invalidateScreen(INVAL_INPUT);
       ledQuickFlash();
     }
   }
@@ -12864,11 +15736,14 @@ void drawPomodoroTimer() {
 
   // Draw progress arc
   if (progress > 0) {
-    for (float i = 0; i < 360 * progress; i+=0.5) {
-      float angle = radians(i - 90); // Start from top
+    // Half-degree steps; trig once per step rather than per ring pixel
+    int steps = 720 * progress;
+    for (int i = 0; i < steps; i++) {
+      uint16_t angle = (uint16_t)((i * 65536) / 720) - 16384; // Start from top
+      int32_t c = fxCos(angle), sn = fxSin(angle);
       for(int j = 0; j < thickness; j++) {
-        int x = centerX + cos(angle) * (radius - j);
-        int y = centerY + sin(angle) * (radius - j);
+        int x = centerX + fxMulQ15(c, radius - j);
+        int y = centerY + fxMulQ15(sn, radius - j);
         canvas.drawPixel(x, y, progressColor);
       }
     }
@@ -12966,8 +15841,6 @@ void drawPomodoroTimer() {
   canvas.fillRect(volBarX + 1, volBarY + 1, volFill, 8, COLOR_PRIMARY);
   canvas.setCursor(volBarX - 23, volBarY + 2);
   canvas.print("VOL");
-
-  tft.drawRGBBitmap(0, 0, canvas.getBuffer(), SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 void updatePomodoroLogic() {